@@ -0,0 +1,571 @@
+/*
+ * ASKRemoteControlCore.h
+ *  ASK RF remote controls signal decoder state machine. It does not depend on the hardware and is shared by the
+ *  firmware and the host tools.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRemoteControlCore_H_
+#define ASKRemoteControlCore_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The lookup tables are kept in the flash memory of AVR microcontrollers, so
+   they do not use RAM.                                                        */
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define ASKRmt_TABLE               PROGMEM
+#define ASKRmt_TABLEREAD(table, i) pgm_read_byte(&(table)[i])
+#else
+#define ASKRmt_TABLE
+#define ASKRmt_TABLEREAD(table, i) ((table)[i])
+#endif
+
+/* Maximum number of bits of a frame. Define it before this file is included
+   to receive longer frames (see ASKRemoteControlDecoder.h).                   */
+#ifndef ASKRmt_MAXFRAMEBITS
+#define ASKRmt_MAXFRAMEBITS 24
+#endif
+
+#if (ASKRmt_MAXFRAMEBITS < 24) || (ASKRmt_MAXFRAMEBITS > 64)
+#error "ASKRmt_MAXFRAMEBITS must be 24 to 64."
+#endif
+
+/* Bytes of the data array of a frame.                                         */
+#ifndef ASKRmt_DATA_SIZE
+#define ASKRmt_DATA_SIZE ((ASKRmt_MAXFRAMEBITS + 7) / 8)
+#endif
+
+/* Shift register that the bits of a frame are received into, the last bit in
+   bit 0.                                                                      */
+#if ASKRmt_MAXFRAMEBITS > 32
+typedef uint64_t ASKRmt_Code;
+#else
+typedef uint32_t ASKRmt_Code;
+#endif
+
+/* Values of BitIndex other than the received bit number.                      */
+#define ASKRmt_BITINDEX_INVALID  253 // packet is invalid, wait for the next preamble
+#define ASKRmt_BITINDEX_IDLE     254 // timer is stopped, wait for the first raise
+#define ASKRmt_BITINDEX_PREAMBLE 255 // check the preamble on the next raise
+
+/* Results of ASKRmt_DecodeEdge. They can be combined.                         */
+#define ASKRmt_EDGE_NONE       0
+#define ASKRmt_EDGE_STARTTIMER 1 // the timer must be started
+#define ASKRmt_EDGE_FRAME      2 // the bits of a frame are received into the data array
+
+/* Description of a protocol. A frame is a sync and MinBits to MaxBits bits,
+   and the sync and each bit are a pair of pulses: a high and a low pulse, or a
+   low and a high pulse if Inverted is true. The lengths of the pulses are in
+   units of the clock of the transmitter. A bit is a short and a long pulse, 1
+   has the long pulse first and 0 has the short pulse first. The long pulse of
+   a bit is accepted if it is longer than (Short + Long) / 2 and shorter than
+   (3 * Long - Short) / 2 short pulses, halfway to the lengths of the other
+   pulse, and the long pulse of the sync if it is longer than SyncMin and
+   shorter than SyncMax short pulses of the sync. A frame ends with its
+   MaxBits-th bit. A shorter frame ends with the sync of the next repeat, or
+   with the timeout after the last repeat, so its length is taken from the gap
+   that follows it. The frame is written into the last bits of the data array
+   of ASKRmt_DATA_SIZE bytes, and the key of a LearningCode remote control is
+   in the KeyMask bits of its last byte. If TriState is true, the bits are the
+   pairs of PT2262 trits (see ASKRmt_TriState) and a packet is invalid as soon
+   as a pair 10 is received. The descriptors are constexpr, so the decoder of
+   each protocol is compiled with its lengths as constants.                    */
+typedef struct
+{
+	uint8_t Id;         // ASKRmt_PROTOCOLID_* value of the received frames
+	uint8_t MinBits;    // bits of the shortest frame, at least 8
+	uint8_t MaxBits;    // bits of the longest frame, at most 64
+	bool    Inverted;   // the pairs are a low and a high pulse
+	uint8_t SyncFirst;  // first pulse of the sync in units
+	uint8_t SyncSecond; // second pulse of the sync in units
+	uint8_t SyncMin;    // bounds of the long pulse of the sync in short pulses of the sync
+	uint8_t SyncMax;
+	uint8_t Short;      // short pulse of a bit in units
+	uint8_t Long;       // long pulse of a bit in units
+	uint8_t KeyMask;    // key bits of the last byte of the data array, the low nibble up to 24 bits
+	bool    TriState;   // the bits are pairs of PT2262 trits
+} ASKRmt_Protocol;
+
+#define ASKRmt_PROTOCOLID_EV1527      0
+#define ASKRmt_PROTOCOLID_PRINCETON10 1
+#define ASKRmt_PROTOCOLID_PRINCETON6  2
+#define ASKRmt_PROTOCOLID_HS2303      3
+#define ASKRmt_PROTOCOLID_HT12E       4
+#define ASKRmt_PROTOCOLID_HT6P20B     5
+#define ASKRmt_PROTOCOLID_EV1527LONG  6
+
+/* EV1527 LearningCode and PT2262 FixCode remote controls. The sync of PT2262
+   ends the frame, so the first frame of a transmission is decoded from its
+   repeat.                                                                     */
+constexpr ASKRmt_Protocol ASKRmt_EV1527      = { ASKRmt_PROTOCOLID_EV1527,      24, 24, false,  1, 31, 27, 33, 1, 3, 0x0F, false };
+/* PT2262 compatible encoders with a 1:10 sync and 1:2 bits.                   */
+constexpr ASKRmt_Protocol ASKRmt_PRINCETON10 = { ASKRmt_PROTOCOLID_PRINCETON10, 24, 24, false,  1, 10,  8, 12, 1, 2, 0x0F, true  };
+/* PT2262 compatible encoders with a 1:6 sync and 1:3 bits.                    */
+constexpr ASKRmt_Protocol ASKRmt_PRINCETON6  = { ASKRmt_PROTOCOLID_PRINCETON6,  24, 24, false,  1,  6,  5,  7, 1, 3, 0x0F, true  };
+/* HS2303-PT with a 2:62 sync and 1:6 bits.                                    */
+constexpr ASKRmt_Protocol ASKRmt_HS2303      = { ASKRmt_PROTOCOLID_HS2303,      24, 24, false,  2, 62, 27, 33, 1, 6, 0x0F, false };
+/* HT12E, 8 address and 4 data bits. The pilot is 12 bits of low level and the
+   sync is a third of a bit of high level, and each bit starts with the low
+   pulse.                                                                      */
+constexpr ASKRmt_Protocol ASKRmt_HT12E       = { ASKRmt_PROTOCOLID_HT12E,       12, 12, true,  36,  1, 32, 40, 1, 2, 0x0F, false };
+/* HT6P20B, 22 address bits, 2 data bits and the 0101 anti-code. The pilot is
+   23 units of low level and the sync is 1 unit of high level, and each bit
+   starts with the low pulse.                                                  */
+constexpr ASKRmt_Protocol ASKRmt_HT6P20B     = { ASKRmt_PROTOCOLID_HT6P20B,     28, 28, true,  23,  1, 20, 26, 1, 2, 0x30, false };
+/* EV1527 compatible encoders with 24 to 32-bit codes, the key in the last 4
+   bits.                                                                       */
+constexpr ASKRmt_Protocol ASKRmt_EV1527LONG  = { ASKRmt_PROTOCOLID_EV1527LONG,  24, 32, false,  1, 31, 27, 33, 1, 3, 0x0F, false };
+
+/* Coefficients of the bit checks of the pulse ratios. The long pulse of a bit
+   is accepted if long * ASKRmt_BitScale is longer than short * ASKRmt_BitMin
+   and shorter than short * ASKRmt_BitMax. They are reduced by their greatest
+   common divisor, so they are 1, 2 and 4 for 1:3 bits.                        */
+constexpr uint8_t ASKRmt_Gcd(uint8_t a, uint8_t b)
+{
+	return b ? ASKRmt_Gcd(b, a % b) : a;
+}
+
+constexpr uint8_t ASKRmt_BitGcd(const ASKRmt_Protocol &p)
+{
+	return ASKRmt_Gcd(ASKRmt_Gcd(2 * p.Short, p.Short + p.Long), 3 * p.Long - p.Short);
+}
+
+constexpr uint8_t ASKRmt_BitScale(const ASKRmt_Protocol &p)
+{
+	return 2 * p.Short / ASKRmt_BitGcd(p);
+}
+
+constexpr uint8_t ASKRmt_BitMin(const ASKRmt_Protocol &p)
+{
+	return (p.Short + p.Long) / ASKRmt_BitGcd(p);
+}
+
+constexpr uint8_t ASKRmt_BitMax(const ASKRmt_Protocol &p)
+{
+	return (3 * p.Long - p.Short) / ASKRmt_BitGcd(p);
+}
+
+/* Returns the number of the lowest key bit of the protocol.                   */
+constexpr uint8_t ASKRmt_MaskShift(uint8_t mask)
+{
+	return (!mask || (mask & 1)) ? 0 : 1 + ASKRmt_MaskShift(mask >> 1);
+}
+
+constexpr uint8_t ASKRmt_KeyShift(const ASKRmt_Protocol &p)
+{
+	return ASKRmt_MaskShift(p.KeyMask);
+}
+
+/* Returns true if the key bits are 1 to 4 adjacent bits, the low nibble for
+   frames of up to 24 bits.                                                    */
+constexpr bool ASKRmt_IsValidKeyMask(const ASKRmt_Protocol &p)
+{
+	return (p.MaxBits <= 24) ? (0x0F == p.KeyMask) : (p.KeyMask && ((p.KeyMask >> ASKRmt_KeyShift(p)) <= 0x0F) && !(((p.KeyMask >> ASKRmt_KeyShift(p)) + 1) & (p.KeyMask >> ASKRmt_KeyShift(p))));
+}
+
+/* Returns true if the descriptor can be decoded by ASKRmt_DecodeEdge. The
+   frames of a tri-state protocol have a fixed even number of bits.            */
+constexpr bool ASKRmt_IsValidProtocol(const ASKRmt_Protocol &p)
+{
+	return (p.MinBits >= 8) && (p.MinBits <= p.MaxBits) && (p.MaxBits <= 64) && (p.Short < p.Long) && (p.SyncMin < p.SyncMax) && ASKRmt_IsValidKeyMask(p) && (!p.TriState || ((p.MinBits == p.MaxBits) && !(p.MaxBits & 1)));
+}
+
+/* PT2262 tri-state codes. A PT2262 frame is 12 trits, 8 address trits and 4
+   data trits, and each trit is a pair of bits: 0 is 00, 1 is 11 and F (the
+   pin is floating) is 01. The pair 10 is never sent. The trits are decoded
+   with ASKRmt_TritNibbles from the 2 pairs of a nibble, so a byte takes 2
+   table reads instead of 4 pair comparisons, and the 8 address trits are
+   packed in base 3 into 13 bits (0 to 6560) instead of 16.                    */
+#define ASKRmt_TRIT_0 0
+#define ASKRmt_TRIT_1 1
+#define ASKRmt_TRIT_F 2
+
+/* Trits of the 2 pairs of bits of each nibble. Bits 0-3 are the 2 trits in
+   base 3 (3 times the first trit plus the second trit), bit 5 is set if the
+   first trit is 1 and bit 4 if the second trit is 1. A nibble with a pair 10
+   is ASKRmt_TRITNIBBLE_INVALID.                                               */
+#define ASKRmt_TRITNIBBLE_INVALID 0x80
+constexpr uint8_t ASKRmt_TritNibbles[16] ASKRmt_TABLE =
+{
+	0x00, 0x02, 0x80, 0x11, // 00 00, 00 01, 00 10, 00 11
+	0x06, 0x08, 0x80, 0x17, // 01 00, 01 01, 01 10, 01 11
+	0x80, 0x80, 0x80, 0x80, // 10 xx
+	0x23, 0x25, 0x80, 0x34  // 11 00, 11 01, 11 10, 11 11
+};
+
+/* Pairs of bits of 2 trits, indexed by the 2 trits in base 3. It is the
+   inverse of ASKRmt_TritNibbles.                                              */
+constexpr uint8_t ASKRmt_TritPairs[9] ASKRmt_TABLE = { 0x0, 0x3, 0x1, 0xC, 0xF, 0xD, 0x4, 0x7, 0x5 };
+
+/* Trits of a PT2262 frame.                                                    */
+typedef struct
+{
+	uint16_t Address; // 8 address trits in base 3, the first trit most significant
+	uint8_t  Data;    // 4 data trits in base 3, the first trit most significant
+	uint8_t  Key;     // data trits that are 1, the first trit in bit 3
+} ASKRmt_TriState;
+
+/* Returns true if no pair of bits of the byte is 10.                          */
+static inline bool ASKRmt_IsTritByte(uint8_t b)
+{
+	return !((b >> 1) & ~b & 0x55);
+}
+
+/* Decodes the 4 trits of a byte in base 3 into "value" (0 to 80) and the
+   trits that are 1 into the low nibble of "ones". Returns false if a pair of
+   bits is 10.                                                                 */
+static inline bool ASKRmt_DecodeTritByte(uint8_t b, uint8_t *value, uint8_t *ones)
+{
+	uint8_t high = ASKRmt_TABLEREAD(ASKRmt_TritNibbles, b >> 4), low = ASKRmt_TABLEREAD(ASKRmt_TritNibbles, b & 0x0F);
+	*value = (high & 0x0F) * 9 + (low & 0x0F);
+	*ones = ((high >> 2) & 0x0C) | ((low >> 4) & 0x03);
+	return !((high | low) & ASKRmt_TRITNIBBLE_INVALID);
+}
+
+/* Decodes the 24 bits of a PT2262 frame in the 3 bytes of "code". Returns
+   false if a pair of bits is 10.                                              */
+static inline bool ASKRmt_DecodeTriState(const uint8_t *code, ASKRmt_TriState *trits)
+{
+	uint8_t high, low, ones;
+	bool valid = ASKRmt_DecodeTritByte(code[0], &high, &ones);
+	valid &= ASKRmt_DecodeTritByte(code[1], &low, &ones);
+	valid &= ASKRmt_DecodeTritByte(code[2], &trits->Data, &trits->Key);
+	trits->Address = high * 81 + low;
+	return valid;
+}
+
+/* Returns the pairs of bits of 4 trits in base 3 (0 to 80).                   */
+static inline uint8_t ASKRmt_EncodeTritByte(uint8_t value)
+{
+	return (ASKRmt_TABLEREAD(ASKRmt_TritPairs, value / 9) << 4) | ASKRmt_TABLEREAD(ASKRmt_TritPairs, value % 9);
+}
+
+/* Writes the 24 bits of the PT2262 frame of the trits into the 3 bytes of
+   "code". The Key of "trits" is not used.                                     */
+static inline void ASKRmt_EncodeTriState(const ASKRmt_TriState *trits, uint8_t *code)
+{
+	code[0] = ASKRmt_EncodeTritByte(trits->Address / 81);
+	code[1] = ASKRmt_EncodeTritByte(trits->Address % 81);
+	code[2] = ASKRmt_EncodeTritByte(trits->Data);
+}
+
+/* Soft combining of the repeats of a frame. If a decoder has a combiner, a bit
+   whose pulse ratio is out of range is received as an uncertain bit instead of
+   invalidating the packet, with 1 if the high time is longer than the low
+   time. A packet with more than ASKRmt_COMBINE_MAXUNCERTAIN uncertain bits is
+   still invalid. The certain bits of the last ASKRmt_COMBINE_FRAMES packets
+   vote for each bit, and a packet with uncertain bits is a frame if the
+   majority decides all of its bits and agrees with its certain bits. The
+   packets are forgotten after ASKRmt_COMBINE_WINDOW preambles (about 45
+   milliseconds each), when a packet of another length is kept or when the
+   decoder is reset, so the repeats of another key are not mixed.              */
+#define ASKRmt_COMBINE_FRAMES       4
+#define ASKRmt_COMBINE_MAXUNCERTAIN 3
+#define ASKRmt_COMBINE_WINDOW       8
+
+#if ASKRmt_COMBINE_FRAMES > 7
+#error "The vote counters of ASKRmt_CombineFrame have 3 bits."
+#endif
+
+/* Kept packets of soft combining. Initialize it with zeros.                   */
+typedef struct
+{
+	uint8_t Data[ASKRmt_COMBINE_FRAMES][ASKRmt_DATA_SIZE];
+	uint8_t Certain[ASKRmt_COMBINE_FRAMES][ASKRmt_DATA_SIZE]; // bits of Data that vote, all 0 in a free or forgotten packet
+	uint8_t Stamp[ASKRmt_COMBINE_FRAMES];                     // value of Preambles when the packet was received
+	uint8_t Next;                                             // packet that is replaced next
+	uint8_t Preambles;                                        // number of received preambles
+	uint8_t Bits;                                             // bits of the kept packets
+	uint8_t Uncertain[ASKRmt_COMBINE_MAXUNCERTAIN];           // numbers of the uncertain bits of the packet being received
+	uint8_t UncertainBits;                                    // number of them
+} ASKRmt_Combiner;
+
+/* Adaptive pulse timing. If ASKRmt_ADAPTIVETIMING is defined before this file
+   is included, the sync (1 short high and 31 short lows for EV1527) sets the
+   length of a unit of the frame, and a bit is a short and a long pulse whose
+   lengths are in the bounds that are computed from it. For 1:3 bits a short
+   pulse is longer than 1/2 and at most 1 3/4 units and a long pulse is longer
+   than 2 1/4 and shorter than 4 units, so the bits are checked with
+   comparisons only and the pulses that have the ratio of a bit but not the
+   length of the pulses of the sync are rejected. A pulse between the short
+   and the long bounds (1/8 of the difference of the long and the short pulse
+   around their middle) is neither, so a bit that is not clearly a 0 or a 1
+   is invalid, or uncertain with soft combining. Otherwise a bit is checked
+   with the ratio of its pulses only.                                          */
+
+/* State of one decoder. Initialize it with ASKRmt_DECODERSTATE_INIT.          */
+typedef struct
+{
+	uint8_t  BitIndex;
+	uint16_t FirstTime; // first pulse of the pair, the high pulse unless the protocol is inverted
+	ASKRmt_Combiner *Combiner;
+	ASKRmt_Code Code;   // received bits of the frame
+	uint8_t  FrameBits; // bits of the last frame
+	#ifdef ASKRmt_ADAPTIVETIMING
+	uint16_t ShortMin; // a short pulse is longer
+	uint16_t ShortMax; // a short pulse is shorter or equal
+	uint16_t LongMin;  // a long pulse is longer
+	uint16_t LongMax;  // a long pulse is shorter
+	#endif
+} ASKRmt_DecoderState;
+
+/* Initial value of a decoder state. "combiner" is a combiner for soft
+   combining or 0.                                                             */
+#ifdef ASKRmt_ADAPTIVETIMING
+#define ASKRmt_DECODERSTATE_INIT(combiner) { ASKRmt_BITINDEX_IDLE, 0, (combiner), 0, 0, 0, 0, 0, 0 }
+#else
+#define ASKRmt_DECODERSTATE_INIT(combiner) { ASKRmt_BITINDEX_IDLE, 0, (combiner), 0, 0 }
+#endif
+
+/* Counts a received preamble and forgets the packets that are too old.        */
+static inline void ASKRmt_CombinerPreamble(ASKRmt_Combiner *c)
+{
+	uint8_t preambles = ++c->Preambles;
+	for (uint8_t i = 0; i < ASKRmt_COMBINE_FRAMES; i++)
+		if ((uint8_t)(preambles - c->Stamp[i]) > ASKRmt_COMBINE_WINDOW)
+			for (uint8_t j = 0; j < ASKRmt_DATA_SIZE; j++) c->Certain[i][j] = 0;
+	c->UncertainBits = 0;
+}
+
+/* Keeps the received packet of "bits" bits in "data" and returns true if it
+   is a frame. The uncertain bits of "data" are replaced by the majority. The
+   votes of each bit are counted in parallel for the 8 bits of a byte by 3-bit
+   counters, whose bit n is in the byte n.                                     */
+static inline bool ASKRmt_CombineFrame(ASKRmt_Combiner *c, uint8_t *data, uint8_t bits)
+{
+	uint8_t n = c->Next, i, j, uncertain[ASKRmt_DATA_SIZE] = { 0 }, result[ASKRmt_DATA_SIZE];
+	for (i = 0; i < c->UncertainBits; i++)
+	{
+		uint8_t b = bits - 1 - c->Uncertain[i]; // bit number from the end of the data array
+		uncertain[ASKRmt_DATA_SIZE - 1 - b / 8] |= (1 << (b % 8));
+	}
+	if (bits != c->Bits) // only the packets of the same length vote together
+	{
+		c->Bits = bits;
+		for (i = 0; i < ASKRmt_COMBINE_FRAMES; i++)
+			for (j = 0; j < ASKRmt_DATA_SIZE; j++) c->Certain[i][j] = 0;
+	}
+	for (j = 0; j < ASKRmt_DATA_SIZE; j++)
+	{
+		c->Data[n][j] = data[j];
+		c->Certain[n][j] = ~uncertain[j];
+	}
+	c->Stamp[n] = c->Preambles;
+	c->Next = (n + 1 == ASKRmt_COMBINE_FRAMES) ? 0 : (n + 1);
+	if (!c->UncertainBits) return true;
+	for (j = 0; j < ASKRmt_DATA_SIZE; j++)
+	{
+		uint8_t o0 = 0, o1 = 0, o2 = 0, z0 = 0, z1 = 0, z2 = 0; // votes for 1 and for 0
+		for (i = 0; i < ASKRmt_COMBINE_FRAMES; i++)
+		{
+			uint8_t one = c->Data[i][j] & c->Certain[i][j], zero = ~c->Data[i][j] & c->Certain[i][j], carry;
+			carry = o0 & one;
+			o0 ^= one;
+			o2 |= o1 & carry;
+			o1 ^= carry;
+			carry = z0 & zero;
+			z0 ^= zero;
+			z2 |= z1 & carry;
+			z1 ^= carry;
+		}
+		uint8_t same2 = ~(o2 ^ z2), same1 = ~(o1 ^ z1);
+		uint8_t more = (o2 & ~z2) | (same2 & ((o1 & ~z1) | (same1 & o0 & ~z0))); // bits with more votes for 1
+		uint8_t less = (z2 & ~o2) | (same2 & ((z1 & ~o1) | (same1 & z0 & ~o0))); // bits with more votes for 0
+		if ((uint8_t)(more | less) != 0xFF) return false; // a bit without votes or with a tie
+		if ((data[j] ^ more) & ~uncertain[j]) return false; // the majority is another code
+		result[j] = more;
+	}
+	for (j = 0; j < ASKRmt_DATA_SIZE; j++) data[j] = result[j];
+	return true;
+}
+
+#ifdef ASKRmt_ADAPTIVETIMING
+/* Returns the length of a unit from the length of the sync. A sync of a power
+   of 2 units is divided by a shift and other syncs are multiplied by the
+   rounded up reciprocal, so the interrupt does not divide.                    */
+static inline uint16_t ASKRmt_SyncUnit(const ASKRmt_Protocol &p, uint32_t sync)
+{
+	uint8_t units = p.SyncFirst + p.SyncSecond;
+	if (!(units & (units - 1))) return sync / units;
+	return (sync * (uint16_t)((65535UL + units) / units)) >> 16;
+}
+
+/* Returns "eighths" eighths of "unit", or 65535 if it is longer.              */
+static inline uint16_t ASKRmt_TimingBound(uint16_t unit, uint16_t eighths)
+{
+	uint32_t bound = ((uint32_t)unit * eighths) >> 3;
+	return (bound > 0xFFFF) ? 0xFFFF : bound;
+}
+#endif
+
+/* Returns true if the pair of pulses is the sync of the protocol "p".         */
+__attribute__((always_inline)) static inline bool ASKRmt_IsSync(const ASKRmt_Protocol &p, uint16_t FirstTime, uint16_t SecondTime)
+{
+	if (p.SyncFirst < p.SyncSecond)
+		return (SecondTime > (FirstTime * p.SyncMin)) && (SecondTime < (FirstTime * p.SyncMax));
+	return (FirstTime > (SecondTime * p.SyncMin)) && (FirstTime < (SecondTime * p.SyncMax));
+}
+
+/* Returns true if the pair of bits that ends with the bit "BitIndex" has an
+   uncertain bit of soft combining.                                            */
+__attribute__((always_inline)) static inline bool ASKRmt_IsUncertainPair(const ASKRmt_DecoderState *state, uint8_t BitIndex)
+{
+	const ASKRmt_Combiner *c = state->Combiner;
+	return c && c->UncertainBits && (c->Uncertain[c->UncertainBits - 1] + 1 >= BitIndex);
+}
+
+/* Writes the frame of "bits" bits of the protocol "p" from the shift register
+   into the last bits of the data array, most significant byte first, and
+   keeps it for soft combining. Returns ASKRmt_EDGE_FRAME, or ASKRmt_EDGE_NONE
+   if the kept packets do not decide its uncertain bits or decide a pair 10 of
+   a tri-state protocol.                                                       */
+__attribute__((always_inline)) static inline uint8_t ASKRmt_EndFrame(const ASKRmt_Protocol &p, ASKRmt_DecoderState *state, uint8_t *data, uint8_t bits)
+{
+	ASKRmt_Code code = state->Code;
+	for (uint8_t i = ASKRmt_DATA_SIZE; i--; code >>= 8) data[i] = (uint8_t)code;
+	state->FrameBits = bits;
+	if (state->Combiner)
+	{
+		if (!ASKRmt_CombineFrame(state->Combiner, data, bits)) return ASKRmt_EDGE_NONE;
+		if (p.TriState) // the pairs with uncertain bits are only checked here
+			for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++)
+				if (!ASKRmt_IsTritByte(data[i])) return ASKRmt_EDGE_NONE;
+	}
+	return ASKRmt_EDGE_FRAME;
+}
+
+/* Decodes one change of the RF signal pin with the protocol "p". "tim" is the
+   time in microseconds since the previous change and "data" is the array of
+   ASKRmt_DATA_SIZE bytes that a frame is written into. The bits are shifted
+   into state->Code, so a bit costs a shift instead of an indexed bit set.
+   Returns a combination of ASKRmt_EDGE_* values. Pass a constexpr descriptor,
+   so the checks are compiled with its lengths as constants. It is always
+   inlined, also when the program is optimized for size, so that the constants
+   are not lost.                                                               */
+__attribute__((always_inline)) static inline uint8_t ASKRmt_DecodeEdge(const ASKRmt_Protocol &p, ASKRmt_DecoderState *state, uint8_t *data, uint8_t pinValue, uint16_t tim)
+{
+	uint8_t r = ASKRmt_EDGE_NONE;
+	if (p.Inverted ? !pinValue : pinValue) // end of a pair (raise, or fall if the protocol is inverted)
+	{
+		uint16_t FirstTime = state->FirstTime, SecondTime = tim;
+		uint8_t  BitIndex = state->BitIndex;
+		if (p.MaxBits > BitIndex) // analyze received bit
+		{
+			#ifdef ASKRmt_ADAPTIVETIMING
+			uint16_t ShortMin = state->ShortMin, ShortMax = state->ShortMax, LongMin = state->LongMin, LongMax = state->LongMax;
+			if ((FirstTime > LongMin) && (FirstTime < LongMax) && (SecondTime > ShortMin) && (SecondTime <= ShortMax)) // check 1 signal (long first, short second)
+				state->Code = (state->Code << 1) | 1;
+			else if ((SecondTime > LongMin) && (SecondTime < LongMax) && (FirstTime > ShortMin) && (FirstTime <= ShortMax)) // check 0 signal (short first, long second)
+				state->Code <<= 1;
+			#else
+			if ((FirstTime * ASKRmt_BitScale(p) > (SecondTime * ASKRmt_BitMin(p))) && (FirstTime * ASKRmt_BitScale(p) < (SecondTime * ASKRmt_BitMax(p)))) // check 1 signal (FirstTime/SecondTime~Long/Short)
+				state->Code = (state->Code << 1) | 1;
+			else if ((SecondTime * ASKRmt_BitScale(p) > (FirstTime * ASKRmt_BitMin(p))) && (SecondTime * ASKRmt_BitScale(p) < (FirstTime * ASKRmt_BitMax(p)))) // check 0 signal (SecondTime/FirstTime~Long/Short)
+				state->Code <<= 1;
+			#endif
+			else if ((p.MinBits < p.MaxBits) && (p.MinBits <= BitIndex) && ASKRmt_IsSync(p, FirstTime, SecondTime)) // the sync of the next repeat ends a shorter frame
+			{
+				r = ASKRmt_EndFrame(p, state, data, BitIndex);
+				BitIndex = ASKRmt_BITINDEX_PREAMBLE; // and starts the next frame
+			}
+			else if (state->Combiner && (state->Combiner->UncertainBits < ASKRmt_COMBINE_MAXUNCERTAIN)) // keep a guess
+			{
+				state->Code = (state->Code << 1) | (FirstTime > SecondTime);
+				state->Combiner->Uncertain[state->Combiner->UncertainBits++] = BitIndex;
+			}
+			else // ignore the entire packet if data is invalid
+				BitIndex = ASKRmt_BITINDEX_INVALID;
+			// a PT2262 frame never has a pair 10, so the rest of the packet is not decoded
+			if (p.TriState && (p.MaxBits > BitIndex) && (BitIndex & 1) && (2 == ((uint8_t)state->Code & 3)) && !ASKRmt_IsUncertainPair(state, BitIndex))
+				BitIndex = ASKRmt_BITINDEX_INVALID;
+		}
+		if (ASKRmt_BITINDEX_PREAMBLE == BitIndex) // check sync signal (SecondTime/FirstTime~31 for EV1527)
+		{
+			if (ASKRmt_IsSync(p, FirstTime, SecondTime))
+			{
+				state->Code = 0;
+				#ifdef ASKRmt_ADAPTIVETIMING
+				uint16_t Unit = ASKRmt_SyncUnit(p, (uint32_t)FirstTime + SecondTime);
+				state->ShortMin = ASKRmt_TimingBound(Unit, 4 * p.Short);
+				state->ShortMax = ASKRmt_TimingBound(Unit, 5 * p.Short + 3 * p.Long);
+				state->LongMin = ASKRmt_TimingBound(Unit, 3 * p.Short + 5 * p.Long);
+				state->LongMax = ASKRmt_TimingBound(Unit, 12 * p.Long - 4 * p.Short);
+				#endif
+				if (state->Combiner) ASKRmt_CombinerPreamble(state->Combiner);
+			}
+			else
+				BitIndex = ASKRmt_BITINDEX_INVALID;
+		}
+		if (ASKRmt_BITINDEX_IDLE == BitIndex) r = ASKRmt_EDGE_STARTTIMER;
+		BitIndex++;
+		if (p.MaxBits == BitIndex) // if all bits received
+		{
+			BitIndex = ASKRmt_BITINDEX_IDLE; // reset BitIndex counter
+			r = ASKRmt_EndFrame(p, state, data, p.MaxBits);
+			// with soft combining this raise starts the preamble of the next repeat, check it to receive all of the repeats
+			if (state->Combiner) BitIndex = ASKRmt_BITINDEX_PREAMBLE;
+		}
+		state->BitIndex = BitIndex;
+	}
+	else // end of the first pulse of a pair
+		state->FirstTime = tim;
+	return r;
+}
+
+/* Ends a frame of less than MaxBits bits of the protocol "p" when the signal
+   is lost after it, which is the gap after the last repeat of a transmission.
+   Returns ASKRmt_EDGE_FRAME if a frame is written into the data array. Call
+   it before ASKRmt_ResetDecoder.                                              */
+__attribute__((always_inline)) static inline uint8_t ASKRmt_DecodeTimeout(const ASKRmt_Protocol &p, ASKRmt_DecoderState *state, uint8_t *data)
+{
+	uint8_t BitIndex = state->BitIndex;
+	if ((p.MinBits == p.MaxBits) || (p.MinBits > BitIndex) || (p.MaxBits <= BitIndex)) return ASKRmt_EDGE_NONE;
+	return ASKRmt_EndFrame(p, state, data, BitIndex);
+}
+
+/* Decodes one change of the RF signal pin with the EV1527 protocol.           */
+static inline uint8_t ASKRmt_DecodeEdge(ASKRmt_DecoderState *state, uint8_t *data, uint8_t pinValue, uint16_t tim)
+{
+	return ASKRmt_DecodeEdge(ASKRmt_EV1527, state, data, pinValue, tim);
+}
+
+/* Resets the decoder after a long time of no signal.                          */
+static inline void ASKRmt_ResetDecoder(ASKRmt_DecoderState *state)
+{
+	state->BitIndex = ASKRmt_BITINDEX_IDLE;
+	if (state->Combiner) // the next signal may be another key
+		for (uint8_t i = 0; i < ASKRmt_COMBINE_FRAMES; i++)
+			for (uint8_t j = 0; j < ASKRmt_DATA_SIZE; j++) state->Combiner->Certain[i][j] = 0;
+}
+
+/* Writes the 3-byte code of a frame of more than 24 bits of the protocol "p"
+   into "code". The bytes before the last 3 bytes of the data array are folded
+   into the first 2 bytes of the code and the key bits of the protocol are
+   moved into the low nibble of the last byte, so the code is compared and its
+   key is read like an EV1527 code. A frame of up to 24 bits is its own code.  */
+__attribute__((always_inline)) static inline void ASKRmt_FoldCode(const ASKRmt_Protocol &p, const uint8_t *data, uint8_t *code)
+{
+	uint8_t code0 = data[ASKRmt_DATA_SIZE - 3], code1 = data[ASKRmt_DATA_SIZE - 2], last = data[ASKRmt_DATA_SIZE - 1];
+	for (uint8_t i = ASKRmt_DATA_SIZE - 3; i--; )
+	{
+		if (i & 1)
+			code1 ^= data[i];
+		else
+			code0 ^= data[i];
+	}
+	code[0] = code0;
+	code[1] = code1;
+	code[2] = (0x0F == p.KeyMask) ? last : ((last & ~p.KeyMask & 0xF0) | ((last & p.KeyMask) >> ASKRmt_KeyShift(p)));
+}
+
+#endif /* ASKRemoteControlCore_H_ */
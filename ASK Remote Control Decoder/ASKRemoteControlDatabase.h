@@ -0,0 +1,344 @@
+/*
+ * ASKRemoteControlDatabase.h
+ *  Sorted database of the saved 3-byte codes on a block storage for thousands of remote controls or keys. It does not
+ *  depend on the hardware and is shared by the firmware and the host tools.
+ *  The storage area starts with the number of used leaves (2 bytes) and the directory, which has an entry of the
+ *  first code and the number of a leaf (5 bytes) for each used leaf in the order of the codes. The leaves follow the
+ *  directory. A leaf is the number of its codes (1 byte) and up to ASKRmt_SORTEDSTORE_LEAFRECORDS codes in ascending
+ *  order, and its codes are smaller than the codes of the leaf of the next directory entry. A lookup is a binary
+ *  search of the directory and a read of one leaf, so it reads O(log n) blocks. A full leaf is split into the first
+ *  free leaf and a leaf that becomes empty is replaced by the last used leaf, so the used leaves are always the
+ *  first leaves. The slot of a code is its leaf number * ASKRmt_SORTEDSTORE_LEAFRECORDS + its position in the leaf.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRemoteControlDatabase_H_
+#define ASKRemoteControlDatabase_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Maximum number of codes of a leaf. It is defined in ASKRemoteControlDecoder.h
+   for the firmware.                                                           */
+#ifndef ASKRmt_SORTEDSTORE_LEAFRECORDS
+#define ASKRmt_SORTEDSTORE_LEAFRECORDS 21
+#endif
+
+#if (ASKRmt_SORTEDSTORE_LEAFRECORDS < 2) || (ASKRmt_SORTEDSTORE_LEAFRECORDS > 84)
+#error "ASKRmt_SORTEDSTORE_LEAFRECORDS must be 2 to 84."
+#endif
+
+#define ASKRmt_DB_LEAFSIZE  (1 + ASKRmt_SORTEDSTORE_LEAFRECORDS * 3)
+#define ASKRmt_DB_ENTRYSIZE 5
+#define ASKRmt_DB_NONE      0xFFFF // no slot
+
+/* Number of leaves of a storage area of "size" bytes.                         */
+#define ASKRmt_DB_LEAVES(size) (((size) - 2) / (ASKRmt_DB_LEAFSIZE + ASKRmt_DB_ENTRYSIZE))
+
+typedef void (*ASKRmt_DBReadFunction)(uint16_t addr, void *dst, uint16_t n);
+typedef void (*ASKRmt_DBWriteFunction)(uint16_t addr, const void *src, uint16_t n);
+typedef bool (*ASKRmt_DBMatchFunction)(const uint8_t *code, const uint8_t *data);
+
+/* Database of a storage area. Read and Write access the storage in blocks.    */
+typedef struct
+{
+	uint16_t               Start;  // storage address of the area
+	uint16_t               Leaves; // number of leaves of the area
+	uint16_t               Used;   // number of used leaves
+	ASKRmt_DBReadFunction  Read;
+	ASKRmt_DBWriteFunction Write;
+} ASKRmt_Database;
+
+static inline int8_t ASKRmt_DBCompare(const uint8_t *a, const uint8_t *b)
+{
+	for (uint8_t i = 0; i < 3; i++)
+		if (a[i] != b[i]) return (a[i] < b[i]) ? -1 : 1;
+	return 0;
+}
+
+static inline uint16_t ASKRmt_DBEntryAddress(const ASKRmt_Database *db, uint16_t entry)
+{
+	return db->Start + 2 + entry * ASKRmt_DB_ENTRYSIZE;
+}
+
+static inline uint16_t ASKRmt_DBLeafAddress(const ASKRmt_Database *db, uint16_t leaf)
+{
+	return db->Start + 2 + db->Leaves * ASKRmt_DB_ENTRYSIZE + leaf * ASKRmt_DB_LEAFSIZE;
+}
+
+/* Reads the number of used leaves. An erased or invalid number is an empty
+   database.                                                                   */
+static inline void ASKRmt_DBOpen(ASKRmt_Database *db)
+{
+	uint8_t used[2];
+	db->Read(db->Start, used, 2);
+	db->Used = used[0] | (used[1] << 8);
+	if (db->Used > db->Leaves) db->Used = 0;
+}
+
+static inline void ASKRmt_DBWriteUsed(ASKRmt_Database *db, uint16_t used)
+{
+	uint8_t bytes[2] = { (uint8_t)used, (uint8_t)(used >> 8) };
+	db->Write(db->Start, bytes, 2);
+	db->Used = used;
+}
+
+/* Returns the directory entry of the leaf of "key": the last entry whose first
+   code is not greater than "key", or the first entry. The database must not
+   be empty.                                                                   */
+static inline uint16_t ASKRmt_DBLocate(const ASKRmt_Database *db, const uint8_t *key)
+{
+	uint16_t lo = 0, hi = db->Used - 1;
+	while (lo < hi)
+	{
+		uint16_t mid = lo + (hi - lo + 1) / 2;
+		uint8_t first[3];
+		db->Read(ASKRmt_DBEntryAddress(db, mid), first, 3);
+		if (ASKRmt_DBCompare(first, key) <= 0)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	return lo;
+}
+
+static inline uint16_t ASKRmt_DBEntryLeaf(const ASKRmt_Database *db, uint16_t entry)
+{
+	uint8_t leaf[2];
+	db->Read(ASKRmt_DBEntryAddress(db, entry) + 3, leaf, 2);
+	return leaf[0] | (leaf[1] << 8);
+}
+
+static inline void ASKRmt_DBWriteEntry(const ASKRmt_Database *db, uint16_t entry, const uint8_t *first, uint16_t leaf)
+{
+	uint8_t bytes[ASKRmt_DB_ENTRYSIZE] = { first[0], first[1], first[2], (uint8_t)leaf, (uint8_t)(leaf >> 8) };
+	db->Write(ASKRmt_DBEntryAddress(db, entry), bytes, ASKRmt_DB_ENTRYSIZE);
+}
+
+/* Moves "count" directory entries from entry "from" to entry "to". The entries
+   are moved in blocks from the end when they move up, so they are read before
+   they are overwritten.                                                       */
+static inline void ASKRmt_DBMoveEntries(const ASKRmt_Database *db, uint16_t from, uint16_t to, uint16_t count)
+{
+	uint8_t buffer[8 * ASKRmt_DB_ENTRYSIZE];
+	while (count)
+	{
+		uint16_t n = (count > 8) ? 8 : count;
+		uint16_t i = (to > from) ? from + count - n : from;
+		db->Read(ASKRmt_DBEntryAddress(db, i), buffer, n * ASKRmt_DB_ENTRYSIZE);
+		db->Write(ASKRmt_DBEntryAddress(db, i + to - from), buffer, n * ASKRmt_DB_ENTRYSIZE);
+		count -= n;
+		if (to < from)
+		{
+			from += n;
+			to += n;
+		}
+	}
+}
+
+/* Reads the number of codes of a leaf and its codes into "buffer". Returns the
+   number of codes.                                                            */
+static inline uint8_t ASKRmt_DBReadLeaf(const ASKRmt_Database *db, uint16_t leaf, uint8_t *buffer)
+{
+	uint16_t addr = ASKRmt_DBLeafAddress(db, leaf);
+	db->Read(addr, buffer, 1);
+	if (buffer[0] > ASKRmt_SORTEDSTORE_LEAFRECORDS) buffer[0] = 0; // the leaf is damaged
+	db->Read(addr + 1, buffer + 1, buffer[0] * 3);
+	return buffer[0];
+}
+
+/* Returns the position of the first code of a leaf buffer that is not smaller
+   than "key".                                                                 */
+static inline uint8_t ASKRmt_DBLowerBound(const uint8_t *buffer, const uint8_t *key)
+{
+	uint8_t lo = 0, hi = buffer[0];
+	while (lo < hi)
+	{
+		uint8_t mid = (lo + hi) / 2;
+		if (ASKRmt_DBCompare(buffer + 1 + mid * 3, key) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* Finds a code that starts with the first "prefix" bytes of "data" and that
+   "match" accepts, and copies it to "code". The codes that start with the
+   same bytes are adjacent and may continue in the next leaf. Returns the slot
+   of the code or ASKRmt_DB_NONE.                                              */
+static inline uint16_t ASKRmt_DBFind(const ASKRmt_Database *db, const uint8_t *data, uint8_t prefix, ASKRmt_DBMatchFunction match, uint8_t *code)
+{
+	if (!db->Used) return ASKRmt_DB_NONE;
+	uint8_t key[3] = { data[0], data[1], (uint8_t)((prefix > 2) ? data[2] : 0) };
+	uint8_t buffer[ASKRmt_DB_LEAFSIZE];
+	uint16_t entry = ASKRmt_DBLocate(db, key);
+	uint16_t leaf = ASKRmt_DBEntryLeaf(db, entry);
+	ASKRmt_DBReadLeaf(db, leaf, buffer);
+	uint8_t i = ASKRmt_DBLowerBound(buffer, key);
+	while (1)
+	{
+		if (i >= buffer[0])
+		{
+			if (++entry >= db->Used) return ASKRmt_DB_NONE;
+			leaf = ASKRmt_DBEntryLeaf(db, entry);
+			ASKRmt_DBReadLeaf(db, leaf, buffer);
+			i = 0;
+			continue;
+		}
+		const uint8_t *c = buffer + 1 + i * 3;
+		for (uint8_t b = 0; b < prefix; b++)
+			if (c[b] != key[b]) return ASKRmt_DB_NONE;
+		if (match(c, data))
+		{
+			code[0] = c[0];
+			code[1] = c[1];
+			code[2] = c[2];
+			return leaf * ASKRmt_SORTEDSTORE_LEAFRECORDS + i;
+		}
+		i++;
+	}
+}
+
+/* Finds the first code that is not smaller than "key" and copies it to
+   "code". Returns its slot or ASKRmt_DB_NONE.                                 */
+static inline uint16_t ASKRmt_DBFirst(const ASKRmt_Database *db, const uint8_t *key, uint8_t *code)
+{
+	if (!db->Used) return ASKRmt_DB_NONE;
+	uint8_t buffer[ASKRmt_DB_LEAFSIZE];
+	uint16_t entry = ASKRmt_DBLocate(db, key);
+	uint16_t leaf = ASKRmt_DBEntryLeaf(db, entry);
+	ASKRmt_DBReadLeaf(db, leaf, buffer);
+	uint8_t i = ASKRmt_DBLowerBound(buffer, key);
+	while (i >= buffer[0])
+	{
+		if (++entry >= db->Used) return ASKRmt_DB_NONE;
+		leaf = ASKRmt_DBEntryLeaf(db, entry);
+		ASKRmt_DBReadLeaf(db, leaf, buffer);
+		i = 0;
+	}
+	code[0] = buffer[1 + i * 3];
+	code[1] = buffer[2 + i * 3];
+	code[2] = buffer[3 + i * 3];
+	return leaf * ASKRmt_SORTEDSTORE_LEAFRECORDS + i;
+}
+
+/* Inserts a code in order. The moved codes are written before the number of
+   codes of the leaf. A full leaf is split: its upper half is written to the
+   first free leaf and an entry of it is inserted into the directory. Returns
+   false if the leaf is full and there is no free leaf.                        */
+static inline bool ASKRmt_DBInsert(ASKRmt_Database *db, const uint8_t *code)
+{
+	uint8_t buffer[1 + (ASKRmt_SORTEDSTORE_LEAFRECORDS + 1) * 3];
+	if (!db->Used)
+	{
+		if (!db->Leaves) return false;
+		buffer[0] = 1;
+		buffer[1] = code[0];
+		buffer[2] = code[1];
+		buffer[3] = code[2];
+		db->Write(ASKRmt_DBLeafAddress(db, 0), buffer, 4);
+		ASKRmt_DBWriteEntry(db, 0, code, 0);
+		ASKRmt_DBWriteUsed(db, 1);
+		return true;
+	}
+	uint16_t entry = ASKRmt_DBLocate(db, code);
+	uint16_t leaf = ASKRmt_DBEntryLeaf(db, entry);
+	uint8_t count = ASKRmt_DBReadLeaf(db, leaf, buffer);
+	if ((count >= ASKRmt_SORTEDSTORE_LEAFRECORDS) && (db->Used >= db->Leaves)) return false;
+	uint8_t i = ASKRmt_DBLowerBound(buffer, code);
+	for (uint8_t j = count * 3; j > i * 3; j--) buffer[j + 3] = buffer[j];
+	buffer[1 + i * 3] = code[0];
+	buffer[2 + i * 3] = code[1];
+	buffer[3 + i * 3] = code[2];
+	count++;
+	uint16_t addr = ASKRmt_DBLeafAddress(db, leaf);
+	if (count <= ASKRmt_SORTEDSTORE_LEAFRECORDS)
+	{
+		buffer[0] = count;
+		db->Write(addr + 1 + i * 3, buffer + 1 + i * 3, (count - i) * 3);
+		db->Write(addr, buffer, 1);
+	}
+	else
+	{
+		uint8_t half = count / 2, upper = count - half;
+		uint16_t next = db->Used; // the first free leaf
+		uint16_t nextAddr = ASKRmt_DBLeafAddress(db, next);
+		db->Write(nextAddr + 1, buffer + 1 + half * 3, upper * 3);
+		db->Write(nextAddr, &upper, 1);
+		ASKRmt_DBMoveEntries(db, entry + 1, entry + 2, db->Used - entry - 1);
+		ASKRmt_DBWriteEntry(db, entry + 1, buffer + 1 + half * 3, next);
+		buffer[0] = half;
+		if (i < half) db->Write(addr + 1 + i * 3, buffer + 1 + i * 3, (half - i) * 3);
+		db->Write(addr, buffer, 1);
+		ASKRmt_DBWriteUsed(db, db->Used + 1);
+	}
+	if (0 == i) ASKRmt_DBWriteEntry(db, entry, code, leaf); // the new first code of the first leaf
+	return true;
+}
+
+/* Deletes the code of a slot. If the leaf becomes empty, its directory entry
+   is removed and the last used leaf is moved to it. Returns false if the slot
+   has no code.                                                                */
+static inline bool ASKRmt_DBDelete(ASKRmt_Database *db, uint16_t slot)
+{
+	uint16_t leaf = slot / ASKRmt_SORTEDSTORE_LEAFRECORDS;
+	uint8_t i = slot % ASKRmt_SORTEDSTORE_LEAFRECORDS;
+	if (leaf >= db->Used) return false;
+	uint8_t buffer[ASKRmt_DB_LEAFSIZE];
+	uint8_t count = ASKRmt_DBReadLeaf(db, leaf, buffer);
+	if (i >= count) return false;
+	uint16_t entry = ASKRmt_DBLocate(db, buffer + 1); // the entry of the leaf has its first code
+	count--;
+	for (uint8_t j = 1 + i * 3; j < 1 + count * 3; j++) buffer[j] = buffer[j + 3];
+	buffer[0] = count;
+	uint16_t addr = ASKRmt_DBLeafAddress(db, leaf);
+	if (count)
+	{
+		db->Write(addr, buffer, 1);
+		db->Write(addr + 1 + i * 3, buffer + 1 + i * 3, (count - i) * 3);
+		if (0 == i) ASKRmt_DBWriteEntry(db, entry, buffer + 1, leaf);
+		return true;
+	}
+	uint16_t last = db->Used - 1;
+	ASKRmt_DBMoveEntries(db, entry + 1, entry, last - entry);
+	db->Used = last; // the directory has one entry less
+	if (leaf != last)
+	{
+		uint8_t n = ASKRmt_DBReadLeaf(db, last, buffer);
+		db->Write(addr + 1, buffer + 1, n * 3);
+		db->Write(addr, buffer, 1);
+		if (n) ASKRmt_DBWriteEntry(db, ASKRmt_DBLocate(db, buffer + 1), buffer + 1, leaf);
+	}
+	ASKRmt_DBWriteUsed(db, last);
+	return true;
+}
+
+/* Deletes all of the codes by writing the number of used leaves only.         */
+static inline void ASKRmt_DBClear(ASKRmt_Database *db)
+{
+	ASKRmt_DBWriteUsed(db, 0);
+}
+
+/* Copies the code of a slot to "code". A slot without a code reads as 0xFF.   */
+static inline void ASKRmt_DBReadSlot(const ASKRmt_Database *db, uint16_t slot, uint8_t *code)
+{
+	uint16_t leaf = slot / ASKRmt_SORTEDSTORE_LEAFRECORDS;
+	uint8_t i = slot % ASKRmt_SORTEDSTORE_LEAFRECORDS;
+	code[0] = code[1] = code[2] = 0xFF;
+	if (leaf >= db->Used) return;
+	uint16_t addr = ASKRmt_DBLeafAddress(db, leaf);
+	uint8_t count;
+	db->Read(addr, &count, 1);
+	if ((i < count) && (count <= ASKRmt_SORTEDSTORE_LEAFRECORDS)) db->Read(addr + 1 + i * 3, code, 3);
+}
+
+#endif /* ASKRemoteControlDatabase_H_ */
@@ -9,118 +9,441 @@
  *
  *   Created: 07 May 2019 01:27 AM
  *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
- * Last Edit: 07 Jun 2021
+ * Last Edit: 16 Oct 2026
  */
 
-#include <avr/io.h>
-#include <avr/cpufunc.h>
-#include <avr/eeprom.h>
 #include "ASKRemoteControlDecoder.h"
+#include "ASKRemoteControlHAL.h"
+#include "ASKRemoteControlCore.h"
 
-uint8_t          BitIndex = 254;
-uint16_t         HighTime, LowTime;
-volatile uint8_t ReceivedData[3];
-volatile bool    DataReceived = false;
+#if defined(ASKRmt_DEFERREDVALIDATION) && !defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) && !defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+#undef ASKRmt_DEFERREDVALIDATION // there is nothing to validate
+#endif
+
+#if defined(ASKRmt_DISPATCHINISR) && defined(ASKRmt_DEFERREDVALIDATION)
+#error "The events of ASKRmt_DISPATCHINISR are looked up in the interrupt. Comment ASKRmt_DEFERREDVALIDATION."
+#endif
+
+#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+#ifdef ASKRmt_SORTEDSTORE
+#include "ASKRemoteControlDatabase.h"
+typedef uint16_t SlotNumber; // the sorted store has thousands of slots
+#else
+typedef uint8_t  SlotNumber;
+#endif
+#endif
+
+/* One decoded frame of the receive queue. The other members cache the EEPROM 
+   lookup result of the frame.                                                 */
+typedef struct
+{
+	uint8_t  Data[ASKRmt_DATA_SIZE]; // received code, in the last bits
+	uint8_t  Bits;      // number of bits of the code
+	#if ASKRmt_DATA_SIZE > 3
+	uint8_t  Code[3];   // 3-byte code of the frame (see FrameCode)
+	#endif
+	uint8_t  Protocol;  // ASKRmt_PROTOCOLID_* value of the protocol
+	#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+	bool     IsSaved;
+	SlotNumber Slot;
+	#endif
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	bool     IsFixCode;
+	#endif
+	#ifdef ASKRmt_DEFERREDVALIDATION
+	bool     IsPending; // the EEPROM lookup is deferred to ASKRmt_Poll
+	#endif
+	uint32_t Time;      // signal time of the frame
+	bool     AfterLoss; // the signal was lost after the previous frame
+} ReceivedFrame;
+
+/* Table of the decoded protocols in the order of the ASKRmt_PROTOCOL_* 
+   definitions.                                                                */
+constexpr ASKRmt_Protocol Protocols[] =
+{
+	#ifdef ASKRmt_PROTOCOL_EV1527
+	ASKRmt_EV1527,
+	#endif
+	#ifdef ASKRmt_PROTOCOL_PRINCETON10
+	ASKRmt_PRINCETON10,
+	#endif
+	#ifdef ASKRmt_PROTOCOL_PRINCETON6
+	ASKRmt_PRINCETON6,
+	#endif
+	#ifdef ASKRmt_PROTOCOL_HS2303
+	ASKRmt_HS2303,
+	#endif
+	#ifdef ASKRmt_PROTOCOL_HT12E
+	ASKRmt_HT12E,
+	#endif
+	#ifdef ASKRmt_PROTOCOL_HT6P20B
+	ASKRmt_HT6P20B,
+	#endif
+	#ifdef ASKRmt_PROTOCOL_EV1527LONG
+	ASKRmt_EV1527LONG,
+	#endif
+};
+constexpr uint8_t ProtocolCount = sizeof(Protocols) / sizeof(Protocols[0]);
+
+/* State of the decoder of the protocol P of the table. Each protocol is 
+   decoded by its own state machine into its own bits, so a frame of one 
+   protocol is not broken by the signal changes that the others reject.        */
+template <uint8_t P> struct ProtocolDecoder
+{
+	static_assert(ASKRmt_IsValidProtocol(Protocols[P]), "The protocol can not be decoded by ASKRmt_DecodeEdge.");
+	static_assert(Protocols[P].MaxBits <= ASKRmt_MAXFRAMEBITS, "Increase ASKRmt_MAXFRAMEBITS to the longest frame of the protocol.");
+	#ifdef ASKRmt_SOFTCOMBINING
+	static ASKRmt_Combiner Combiner; // kept packets of soft combining
+	#endif
+	static ASKRmt_DecoderState State;
+};
+
+#ifdef ASKRmt_SOFTCOMBINING
+template <uint8_t P> ASKRmt_Combiner ProtocolDecoder<P>::Combiner;
+template <uint8_t P> ASKRmt_DecoderState ProtocolDecoder<P>::State = ASKRmt_DECODERSTATE_INIT(&ProtocolDecoder<P>::Combiner);
+#else
+template <uint8_t P> ASKRmt_DecoderState ProtocolDecoder<P>::State = ASKRmt_DECODERSTATE_INIT(0);
+#endif
+
+/* Single-producer/single-consumer ring of received frames. The ISR assembles 
+   the bits into the free slot at QueueTail and publishes it by advancing 
+   QueueTail. The main loop reads the slot at QueueHead and releases it by 
+   advancing QueueHead. Each index is written by one side only, so no 
+   interrupt locking is needed.                                                */
+ReceivedFrame    ReceiveQueue[ASKRmt_RECEIVEQUEUE_SIZE];
+volatile uint8_t QueueHead = 0, QueueTail = 0;
+volatile uint8_t ASKRmt_ReceiveQueueOverflows = 0;
+
+/* Time of the RF signal in microseconds. The front ends add the time between 
+   the signal changes and the timeout, so it stops while the timer is stopped 
+   after the signal is lost. LostTime is the time when the signal was lost.    */
+volatile uint32_t SignalTime = 0, LostTime = 0;
+bool              LostAfterFrame = true; // the signal was lost after the last received frame
+
+#ifdef ASKRmt_COLLAPSEREPEATS
+/* The code and the signal time of the last received frame that is not 
+   dropped for a full queue, and the number of its repeats that are dropped 
+   since ASKRmt_Dispatch has delivered them.                                   */
+uint8_t           LastCode[ASKRmt_DATA_SIZE];
+volatile uint32_t LastCodeTime;
+volatile uint8_t  Repeats = 0;
+#endif
+
+void DeliverFrame(ASKRmt_Event *event, uint32_t time, bool afterLoss);
+void DeliverRepeat(uint32_t time);
+void CheckRelease(uint32_t now, uint32_t lost);
+bool IsPressedCode(const uint8_t *code);
+#ifdef ASKRmt_DISPATCHINISR
+void ResolveEvent(ReceivedFrame *frame, ASKRmt_Event *event);
+#endif
 
 #ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
 volatile bool    ASKRmt_AutoDiscardUnsavedRemotes = true;
-uint16_t         RemoteCodeAddr;
-bool             IsRemoteFixCode, IsRemoteSaved;
 
-bool CheckIsRemoteSaved(void);
+bool CheckIsRemoteSaved(ReceivedFrame *frame);
 #endif
 
 #ifdef ASKRmt_SAVEKEYCODESTOEEPROM
 volatile bool    ASKRmt_AutoDiscardUnsavedKeys = true;
-uint16_t         KeyCodeAddr;
-bool             IsKeySaved;
 
-bool CheckIsKeySaved(void);
+bool CheckIsKeySaved(ReceivedFrame *frame);
 #endif
 
+#ifdef ASKRmt_COLLAPSEREPEATS
+/* Returns true and counts the frame as a repeat if it has the code of the last 
+   frame and it is received at most ASKRmt_REPEAT_GAP milliseconds after it 
+   without a signal loss.                                                      */
+static inline bool CollapseRepeat(const uint8_t *data)
+{
+	uint32_t time = SignalTime;
+	if (LostAfterFrame || (time - LastCodeTime > ASKRmt_REPEAT_GAP * 1000UL)) return false;
+	for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++)
+		if (data[i] != LastCode[i]) return false;
+	LastCodeTime = time;
+	#ifdef ASKRmt_DISPATCHINISR
+	if (IsPressedCode(data)) DeliverRepeat(time);
+	#else
+	if (255 != Repeats) Repeats++;
+	#endif
+	return true;
+}
+#endif
+
+/* Publishes the frame that is received into the tail slot of the queue.       */
+static inline void PublishFrame(uint8_t tail, ReceivedFrame *frame)
+{
+	#ifdef ASKRmt_COLLAPSEREPEATS
+	if (CollapseRepeat(frame->Data)) return;
+	#endif
+	uint8_t next = (tail + 1) & (ASKRmt_RECEIVEQUEUE_SIZE - 1);
+	if (next == QueueHead) // drop the frame if the queue is full
+	{
+		if (255 != ASKRmt_ReceiveQueueOverflows) ASKRmt_ReceiveQueueOverflows++;
+		return;
+	}
+	#ifdef ASKRmt_COLLAPSEREPEATS
+	// the next repeats of the code are collapsed into this frame, also if it is discarded
+	for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) LastCode[i] = frame->Data[i];
+	LastCodeTime = SignalTime;
+	Repeats = 0;
+	#endif
+	#ifdef ASKRmt_DEFERREDVALIDATION
+	// only mark the frame, ASKRmt_Poll looks it up in the EEPROM
+	frame->IsSaved = false;
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	frame->IsPending = ASKRmt_AutoDiscardUnsavedRemotes;
+	#endif
+	#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+	frame->IsPending = ASKRmt_AutoDiscardUnsavedKeys;
+	#endif
+	#else
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	frame->IsSaved = false;
+	if (ASKRmt_AutoDiscardUnsavedRemotes) {
+		frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (!frame->IsSaved) return;
+	}
+	#endif
+	#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+	frame->IsSaved = false;
+	if (ASKRmt_AutoDiscardUnsavedKeys) {
+		frame->IsSaved = CheckIsKeySaved(frame);
+		if (!frame->IsSaved) return;
+	}
+	#endif
+	#endif
+	#ifdef ASKRmt_DISPATCHINISR
+	// deliver the frame instead of publishing it
+	ASKRmt_Event event;
+	ResolveEvent(frame, &event);
+	DeliverFrame(&event, SignalTime, LostAfterFrame);
+	#else
+	frame->Time = SignalTime;
+	frame->AfterLoss = LostAfterFrame;
+	ASKRmt_HAL_MEMORYBARRIER(); // the frame must be complete before it is published
+	QueueTail = next; // raise the received flag
+	#endif
+	LostAfterFrame = false;
+}
+
+/* Returns the 3-byte code of a frame that is saved and looked up in the 
+   EEPROM. A frame of up to 24 bits is its own code. The bytes before the last 
+   3 bytes of a longer frame are folded into the first 2 bytes of its code and 
+   the key bits of its protocol are moved into the low nibble of the last 
+   byte, so the code is compared and its key is read like an EV1527 code.      */
+static inline const uint8_t *FrameCode(const ReceivedFrame *frame)
+{
+	#if ASKRmt_DATA_SIZE > 3
+	return frame->Code;
+	#else
+	return frame->Data;
+	#endif
+}
+
+/* Publishes the frame of the protocol P that is written into the tail slot.   */
+template <uint8_t P> static inline void PublishProtocolFrame(uint8_t tail, ReceivedFrame *frame)
+{
+	constexpr ASKRmt_Protocol p = Protocols[P];
+	frame->Bits = (p.MinBits == p.MaxBits) ? p.MaxBits : ProtocolDecoder<P>::State.FrameBits;
+	frame->Protocol = p.Id;
+	#if ASKRmt_DATA_SIZE > 3
+	ASKRmt_FoldCode(p, frame->Data, frame->Code);
+	#endif
+	PublishFrame(tail, frame);
+}
+
+/* Decodes a change of the RF signal pin with the decoders of the protocols 
+   from P to the end of the table and publishes their frames. Each decoder is 
+   a separate instance, so its descriptor is compiled into constants and the 
+   table is not read. A frame is written into the free tail slot of the queue 
+   when its last bit is received. Returns the combined results of 
+   ASKRmt_DecodeEdge.                                                          */
+template <uint8_t P> static inline uint8_t DecodeProtocols(uint8_t pinValue, uint16_t tim);
+
+template <> inline uint8_t DecodeProtocols<ProtocolCount>(uint8_t, uint16_t)
+{
+	return ASKRmt_EDGE_NONE;
+}
+
+template <uint8_t P> static inline uint8_t DecodeProtocols(uint8_t pinValue, uint16_t tim)
+{
+	uint8_t tail = QueueTail;
+	ReceivedFrame *frame = &ReceiveQueue[tail]; // the tail slot is always free
+	uint8_t r = ASKRmt_DecodeEdge(Protocols[P], &ProtocolDecoder<P>::State, frame->Data, pinValue, tim);
+	if (r & ASKRmt_EDGE_FRAME) PublishProtocolFrame<P>(tail, frame); // if all bits received
+	return r | DecodeProtocols<P + 1>(pinValue, tim);
+}
+
+/* Publishes the frames of less than the maximum number of bits that the 
+   timeout ends and resets the decoders of the protocols from P to the end of 
+   the table.                                                                  */
+template <uint8_t P> static inline void ResetProtocols(void);
+
+template <> inline void ResetProtocols<ProtocolCount>(void)
+{
+}
+
+template <uint8_t P> static inline void ResetProtocols(void)
+{
+	uint8_t tail = QueueTail;
+	ReceivedFrame *frame = &ReceiveQueue[tail]; // the tail slot is always free
+	if (ASKRmt_DecodeTimeout(Protocols[P], &ProtocolDecoder<P>::State, frame->Data) & ASKRmt_EDGE_FRAME) PublishProtocolFrame<P>(tail, frame);
+	ASKRmt_ResetDecoder(&ProtocolDecoder<P>::State);
+	ResetProtocols<P + 1>();
+}
+
+/* Decodes a change of the RF signal pin that is "tim" microseconds after the 
+   previous change. Returns the combined results of ASKRmt_DecodeEdge.         */
+static inline uint8_t DecodeSignalChange(uint8_t pinValue, uint16_t tim)
+{
+	SignalTime += tim;
+	uint8_t r = DecodeProtocols<0>(pinValue, tim);
+	#ifdef ASKRmt_DISPATCHINISR
+	if (!(r & ASKRmt_EDGE_FRAME)) CheckRelease(SignalTime, LostTime);
+	#endif
+	return r;
+}
+
+/* Counts the timeout of 65536 microseconds without a signal change.           */
+static inline void SignalLost(void)
+{
+	SignalTime += 65536;
+	LostTime = SignalTime;
+	LostAfterFrame = true;
+	#ifdef ASKRmt_DISPATCHINISR
+	CheckRelease(SignalTime, LostTime);
+	#endif
+}
+
+#ifndef ASKRmt_INPUTCAPTURE
+
 void ASKRmt_RFSignalPinChanged(uint8_t pinValue)
 {
-	// discard signal if there is unread data
-	if (DataReceived) return;
 	// read timer counter value and reset it
 	uint16_t tim;
-	tim = ASKRmt_2BYTE1MHZTIMER_COUNTERVALUE; // atomic read/write is not needed inside ISR
-	ASKRmt_2BYTE1MHZTIMER_RESETCOUNTER; // atomic read/write is not needed inside ISR
-	// check signal pin
-	if (pinValue) // raise
-	{
-		LowTime = tim;
-		if (24 > BitIndex) // analyze received bit
-		{
-			if ((HighTime > (LowTime * 2)) && (HighTime < (LowTime * 4))) // check 1 signal (HighTime/LowTime~3)
-				ReceivedData[BitIndex / 8] |= (1 << (7 - (BitIndex % 8)));
-			else if ((LowTime > (HighTime * 2)) && (LowTime < (HighTime * 4))) // check 0 signal (LowTime/HighTime~3)
-				_NOP();
-			else // ignore the entire packet if data is invalid
-				BitIndex = 253;
-		}
-		if (255 == BitIndex) // check preamble signal (LowTime/HighTime~30)
-		{
-			if ((LowTime > (HighTime * 27)) && (LowTime < (HighTime * 33)))
-			{
-				ReceivedData[0] = 0;
-				ReceivedData[1] = 0;
-				ReceivedData[2] = 0;
-			}
-			else
-				BitIndex = 253;
-		}
-		if (254 == BitIndex) ASKRmt_2BYTE1MHZTIMER_START; // start timer
-		BitIndex++;
-		if (24 == BitIndex) // if 24 bits received
-		{
-			DataReceived = true; // raise the received flag
-			BitIndex = 254;      // reset BitIndex counter
-			#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
-			IsRemoteSaved = false;
-			if (ASKRmt_AutoDiscardUnsavedRemotes) {
-				IsRemoteSaved = CheckIsRemoteSaved();
-				DataReceived = IsRemoteSaved;
-			}
-			#endif
-			#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
-			IsKeySaved = false;
-			if (ASKRmt_AutoDiscardUnsavedKeys) {
-				IsKeySaved = CheckIsKeySaved();
-				DataReceived = IsKeySaved;
-			}
-			#endif
-		}
-	}
-	else // fall
-		HighTime = tim;
+	tim = ASKRmt_HAL_TIMERVALUE(); // atomic read/write is not needed inside ISR
+	ASKRmt_HAL_TIMERRESET(); // atomic read/write is not needed inside ISR
+	if (DecodeSignalChange(pinValue, tim) & ASKRmt_EDGE_STARTTIMER) ASKRmt_HAL_TIMERSTART(); // start timer
 }
 
 void ASKRmt_TwoByte1MHzTimerOverflowInterrupt(void)
 {
 	// stop timer and reset bit counter after about 65 milliseconds of no signal
 	// This part will never executes when the ASK RF receiver module is on. Because there is a lot of RF noise.
-	ASKRmt_2BYTE1MHZTIMER_STOP;
-	BitIndex = 254;
+	ASKRmt_HAL_TIMERSTOP();
+	ResetProtocols<0>();
+	SignalLost();
+}
+
+#else
+
+uint16_t LastCapture;            // capture time of the previous change
+bool     TimeoutRunning = false; // the timeout runs like the timer of the pin change front end
+
+void ASKRmt_InputCaptureInterrupt(void)
+{
+	uint16_t capture = ASKRmt_HAL_CAPTUREVALUE(); // atomic read is not needed inside ISR
+	uint8_t pinValue = ASKRmt_HAL_CAPTUREISRAISE() ? 1 : 0;
+	ASKRmt_HAL_CAPTURETOGGLEEDGE(); // capture the next change
+	// the timeout has a lower priority, handle it first if it occurred before this change
+	if (ASKRmt_HAL_TIMEOUTPENDING()) ASKRmt_InputCaptureTimeoutInterrupt();
+	uint16_t tim = 0; // the stopped timer of the pin change front end reads 0
+	if (TimeoutRunning)
+	{
+		tim = capture - LastCapture; // the counter is never reset, so the difference wraps correctly
+		ASKRmt_HAL_TIMEOUTSTART(capture); // the timeout is counted from the last change
+	}
+	LastCapture = capture;
+	if (DecodeSignalChange(pinValue, tim) & ASKRmt_EDGE_STARTTIMER)
+	{
+		TimeoutRunning = true;
+		ASKRmt_HAL_TIMEOUTSTART(capture);
+	}
+}
+
+void ASKRmt_InputCaptureTimeoutInterrupt(void)
+{
+	// reset bit counter after 65536 microseconds of no signal
+	ASKRmt_HAL_TIMEOUTSTOP();
+	TimeoutRunning = false;
+	ResetProtocols<0>();
+	SignalLost();
+}
+
+#endif
+
+/* Returns the oldest received frame or 0 if the queue is empty. The frame may 
+   still be pending validation.                                                */
+ReceivedFrame *PeekHeadFrame(void)
+{
+	if (QueueHead == QueueTail) return 0;
+	ASKRmt_HAL_MEMORYBARRIER(); // the frame must be read after QueueTail
+	return &ReceiveQueue[QueueHead];
+}
+
+/* Releases the oldest received frame. The queue must not be empty.            */
+void PopHeadFrame(void)
+{
+	ASKRmt_HAL_MEMORYBARRIER(); // the frame must be read before it is released
+	QueueHead = (QueueHead + 1) & (ASKRmt_RECEIVEQUEUE_SIZE - 1);
 }
 
+void ASKRmt_Poll(void)
+{
+	#ifdef ASKRmt_DEFERREDVALIDATION
+	ReceivedFrame *frame;
+	while ((frame = PeekHeadFrame()) && frame->IsPending)
+	{
+		frame->IsPending = false;
+		#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+		frame->IsSaved = CheckIsRemoteSaved(frame);
+		#endif
+		#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+		frame->IsSaved = CheckIsKeySaved(frame);
+		#endif
+		if (frame->IsSaved) break;
+		PopHeadFrame(); // discard the unsaved code
+	}
+	#endif
+}
+
+/* Returns the oldest validated frame or 0 if there is no such frame.          */
+ReceivedFrame *GetHeadFrame(void)
+{
+	#ifdef ASKRmt_DEFERREDVALIDATION
+	ASKRmt_Poll();
+	#endif
+	return PeekHeadFrame();
+}
+
+#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+/* Clears the cached EEPROM lookup results of the queued frames after a code 
+   has been deleted from the EEPROM.                                           */
+void InvalidateQueuedLookups(void)
+{
+	uint8_t tail = QueueTail;
+	ASKRmt_HAL_MEMORYBARRIER(); // the frames must be written after QueueTail is read
+	for (uint8_t i = QueueHead; i != tail; i = (i + 1) & (ASKRmt_RECEIVEQUEUE_SIZE - 1))
+		ReceiveQueue[i].IsSaved = false;
+}
+#endif
+
 bool ASKRmt_IsDataReceived(void)
 {
-	return DataReceived;
+	return (GetHeadFrame() != 0);
 }
 
 void ASKRmt_DiscardData(void)
 {
-	DataReceived = false;
+	if (GetHeadFrame()) PopHeadFrame();
 }
 
 bool ASKRmt_GetData(uint8_t *data)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		data[0] = ReceivedData[0];
-		data[1] = ReceivedData[1];
-		data[2] = ReceivedData[2];
+		for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) data[i] = frame->Data[i];
 		return true;
 	}
 	return false;
@@ -128,81 +451,1219 @@ bool ASKRmt_GetData(uint8_t *data)
 
 bool ASKRmt_PickData(uint8_t *data)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		data[0] = ReceivedData[0];
-		data[1] = ReceivedData[1];
-		data[2] = ReceivedData[2];
-		DataReceived = false;
+		for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) data[i] = frame->Data[i];
+		PopHeadFrame();
 		return true;
 	}
 	return false;
 }
 
-uint8_t GetFixCodeKey(void)
+/* Returns the key of a FixCode remote control, the data trits that are 1.     */
+uint8_t GetFixCodeKey(const uint8_t *data)
+{
+	uint8_t value, ones;
+	ASKRmt_DecodeTritByte(data[2], &value, &ones);
+	return ones;
+}
+
+/* Returns the key of a LearningCode remote control, the low nibble of the code 
+   of the frame.                                                               */
+uint8_t GetLearningCodeKey(const ReceivedFrame *frame)
 {
-	return (((ReceivedData[2] >> 3) & 0b1100) | ((ReceivedData[2] >> 1) & 0b0011));
+	return FrameCode(frame)[2] & 0xF;
+}
+
+int8_t ASKRmt_GetProtocol(void)
+{
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame) return frame->Protocol;
+	return -1;
+}
+
+int8_t ASKRmt_GetDataBits(void)
+{
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame) return frame->Bits;
+	return -1;
+}
+
+int16_t ASKRmt_GetTriStateAddress(void)
+{
+	ReceivedFrame *frame = GetHeadFrame();
+	ASKRmt_TriState trits;
+	if (frame && (24 == frame->Bits) && ASKRmt_DecodeTriState(FrameCode(frame), &trits)) return trits.Address;
+	return -1;
 }
 
 int8_t ASKRmt_GetKey(bool isFixCode)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
 		if (isFixCode)
-			return GetFixCodeKey();
+			return GetFixCodeKey(FrameCode(frame));
 		else
-			return (ReceivedData[2] & 0xF);
+			return GetLearningCodeKey(frame);
 	}
 	return -1;
 }
 
 int8_t ASKRmt_PickKey(bool isFixCode)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
 		int8_t r;
 		if (isFixCode)
-			r = GetFixCodeKey();
+			r = GetFixCodeKey(FrameCode(frame));
 		else
-			r = ReceivedData[2] & 0xF;
-		DataReceived = false;
+			r = GetLearningCodeKey(frame);
+		PopHeadFrame();
 		return r;
 	}
 	return -1;
 }
 
-#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+bool ASKRmt_IsReceiveQueueEmpty(void)
+{
+	return (QueueHead == QueueTail);
+}
 
-bool CheckIsRemoteSaved(void)
+ASKRmt_EventHandler FrameHandler = 0, PressHandler = 0;
+bool         IsPressed = false; // the press of PressEvent is not released
+ASKRmt_Event PressEvent;
+uint32_t     PressStart;        // signal time of the first frame of the press
+uint32_t     PressTime;         // signal time of the last frame of the press
+
+void ASKRmt_SetFrameHandler(ASKRmt_EventHandler handler)
 {
-	uint8_t val01, val2;
-	for (RemoteCodeAddr = ASKRmt_EEPROM_START; RemoteCodeAddr < ASKRmt_EEPROM_END; RemoteCodeAddr += 3)
+	ASKRmt_HAL_ATOMIC // the interrupt may call it
 	{
-		val2 = eeprom_read_byte((const uint8_t *)(RemoteCodeAddr + 2));
-		if (0xFF == val2) continue;
-		val01 = eeprom_read_byte((const uint8_t *)RemoteCodeAddr);
-		if (val01 != ReceivedData[0]) continue;
-		val01 = eeprom_read_byte((const uint8_t *)(RemoteCodeAddr + 1));
-		if (val01 != ReceivedData[1]) continue;
-		// least significant nibble of 3rd byte is the remote control type (0:LearningCode, 1:FixCode)
-		IsRemoteFixCode = (val2 & 1);
-		if (IsRemoteFixCode) return true; // if remote control is code fix don't compare third byte
-		if (val2 == (ReceivedData[2] & 0xF0)) return true;
+		FrameHandler = handler;
 	}
-	return false;
+}
+
+void ASKRmt_SetPressHandler(ASKRmt_EventHandler handler)
+{
+	ASKRmt_HAL_ATOMIC // the interrupt may call it
+	{
+		PressHandler = handler;
+	}
+}
+
+/* Fills the event of a received frame with its EEPROM lookup result.          */
+void ResolveEvent(ReceivedFrame *frame, ASKRmt_Event *event)
+{
+	for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) event->Data[i] = frame->Data[i];
+	event->Bits = frame->Bits;
+	event->Protocol = frame->Protocol;
+	event->IsSaved = false;
+	event->Key = 0;
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+	if (frame->IsSaved)
+	{
+		event->IsSaved = true;
+		event->Key = frame->IsFixCode ? GetFixCodeKey(FrameCode(frame)) : GetLearningCodeKey(frame);
+	}
+	#endif
+	#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+	if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+	if (frame->IsSaved)
+	{
+		event->IsSaved = true;
+		event->Key = FrameCode(frame)[2];
+	}
+	#endif
+}
+
+/* Returns true if a key is pressed and its code is "code".                    */
+bool IsPressedCode(const uint8_t *code)
+{
+	if (!IsPressed) return false;
+	for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++)
+		if (PressEvent.Data[i] != code[i]) return false;
+	return true;
+}
+
+/* Returns the milliseconds from the first to the last frame of the press.     */
+uint16_t PressDuration(void)
+{
+	uint32_t ms = (PressTime - PressStart) / 1000;
+	return (ms > 0xFFFF) ? 0xFFFF : ms;
+}
+
+void ReleasePress(void)
+{
+	IsPressed = false;
+	PressEvent.Type = ASKRmt_EVENT_RELEASE;
+	PressEvent.Duration = PressDuration();
+	if (PressHandler) PressHandler(&PressEvent);
+}
+
+/* Delivers the HOLD event of a repeat of the pressed key that is received at 
+   signal time "time".                                                         */
+void DeliverRepeat(uint32_t time)
+{
+	PressTime = time;
+	PressEvent.Type = ASKRmt_EVENT_HOLD;
+	PressEvent.Duration = PressDuration();
+	if (PressHandler) PressHandler(&PressEvent);
+}
+
+/* Releases the press if its code has not been received for ASKRmt_REPEAT_GAP 
+   milliseconds or the signal has been lost after its last frame.              */
+void CheckRelease(uint32_t now, uint32_t lost)
+{
+	if (IsPressed && ((now - PressTime > ASKRmt_REPEAT_GAP * 1000UL) || ((int32_t)(lost - PressTime) > 0)))
+		ReleasePress();
+}
+
+/* Delivers the event of a frame that is received at signal time "time" and 
+   the press and release events of its key. "afterLoss" is true if the signal 
+   was lost after the previous frame.                                          */
+void DeliverFrame(ASKRmt_Event *event, uint32_t time, bool afterLoss)
+{
+	event->Type = ASKRmt_EVENT_FRAME;
+	if (FrameHandler) FrameHandler(event);
+	if (IsPressed && (afterLoss || (time - PressTime > ASKRmt_REPEAT_GAP * 1000UL))) ReleasePress();
+	if (IsPressed)
+	{
+		if (IsPressedCode(event->Data))
+		{
+			DeliverRepeat(time);
+			return;
+		}
+		ReleasePress(); // another key is pressed
+	}
+	PressEvent = *event;
+	PressEvent.Type = ASKRmt_EVENT_PRESS;
+	PressEvent.Duration = 0;
+	PressStart = time;
+	PressTime = time;
+	IsPressed = true;
+	if (PressHandler) PressHandler(&PressEvent);
+}
+
+void ASKRmt_Dispatch(void)
+{
+	#ifndef ASKRmt_DISPATCHINISR
+	ReceivedFrame *frame;
+	while ((frame = GetHeadFrame()))
+	{
+		ASKRmt_Event event;
+		ResolveEvent(frame, &event);
+		uint8_t head = QueueHead;
+		DeliverFrame(&event, frame->Time, frame->AfterLoss);
+		if (head == QueueHead) PopHeadFrame(); // unless a handler has picked it
+	}
+	uint32_t now, lost;
+	#ifdef ASKRmt_COLLAPSEREPEATS
+	uint8_t repeats = 0, code[ASKRmt_DATA_SIZE];
+	uint32_t repeatTime;
+	#endif
+	ASKRmt_HAL_ATOMIC // the interrupts change them
+	{
+		now = SignalTime;
+		lost = LostTime;
+		#ifdef ASKRmt_COLLAPSEREPEATS
+		if (QueueHead == QueueTail) // the repeats are newer than the delivered frames
+		{
+			repeats = Repeats;
+			Repeats = 0;
+			repeatTime = LastCodeTime;
+			for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) code[i] = LastCode[i];
+		}
+		#endif
+	}
+	#ifdef ASKRmt_COLLAPSEREPEATS
+	if (repeats && IsPressedCode(code)) DeliverRepeat(repeatTime);
+	#endif
+	CheckRelease(now, lost);
+	#endif
+}
+
+#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+
+#if defined(ASKRmt_SORTEDSTORE) && defined(ASKRmt_JOURNALEDSTORE)
+#error "Define only one of ASKRmt_SORTEDSTORE and ASKRmt_JOURNALEDSTORE."
+#endif
+
+#if defined(ASKRmt_TRITPACKEDSTORE) && (defined(ASKRmt_SORTEDSTORE) || defined(ASKRmt_JOURNALEDSTORE) || !defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM))
+#error "The trit-packed store saves remote controls to fixed slots. Define ASKRmt_SAVEREMOTECONTROLSTOEEPROM only."
+#endif
+
+#ifdef ASKRmt_TRITPACKEDSTORE
+/* A slot of the trit-packed store is the packed address of a FixCode remote 
+   control (see PackSlot).                                                     */
+#define SLOT_SIZE 2
+#else
+#define SLOT_SIZE 3
+#endif
+
+#ifdef ASKRmt_JOURNALEDSTORE
+/* The journaled store splits ASKRmt_EEPROM_START..ASKRmt_EEPROM_END into 2 
+   banks. A bank is a 2-byte header (the sequence number of the bank and its 
+   complement) and 5-byte records (slot, 3 code bytes and CRC). A bank holds 
+   twice the number of slots, so at least half of it is free after it is 
+   compacted.                                                                  */
+#define JOURNAL_BANK_SIZE   ((ASKRmt_EEPROM_END - ASKRmt_EEPROM_START + 1) / 2)
+#define JOURNAL_RECORD_SIZE 5
+#define JOURNAL_RECORDS     ((JOURNAL_BANK_SIZE - 2) / JOURNAL_RECORD_SIZE)
+#define SLOT_COUNT          (JOURNAL_RECORDS / 2)
+
+#if SLOT_COUNT < 1
+#error "The journaled store needs at least 24 bytes. Increase ASKRmt_EEPROM_END - ASKRmt_EEPROM_START."
+#endif
+#elif defined(ASKRmt_SORTEDSTORE)
+/* The sorted store splits ASKRmt_EEPROM_START..ASKRmt_EEPROM_END into a 
+   directory and leaves (see ASKRemoteControlDatabase.h). A slot is a position 
+   of a leaf, so the free slots are the unused positions of the leaves.        */
+#define SORTED_LEAVES ASKRmt_DB_LEAVES(ASKRmt_EEPROM_END - ASKRmt_EEPROM_START + 1)
+#define SLOT_COUNT    (SORTED_LEAVES * ASKRmt_SORTEDSTORE_LEAFRECORDS)
+
+#if SORTED_LEAVES < 1
+#error "The sorted store needs at least one leaf. Increase ASKRmt_EEPROM_END - ASKRmt_EEPROM_START."
+#endif
+#else
+/* Number of code slots between ASKRmt_EEPROM_START and ASKRmt_EEPROM_END. The 
+   last byte of a free slot is 0xFF.                                           */
+#define SLOT_COUNT ((ASKRmt_EEPROM_END - ASKRmt_EEPROM_START + SLOT_SIZE - 1) / SLOT_SIZE)
+#endif
+#ifdef ASKRmt_SORTEDSTORE
+#define NO_SLOT    ASKRmt_DB_NONE
+
+#if SLOT_COUNT >= ASKRmt_DB_NONE
+#error "Too many sorted store slots. Reduce ASKRmt_EEPROM_END - ASKRmt_EEPROM_START."
+#endif
+#else
+#define NO_SLOT    0xFF
+
+#if SLOT_COUNT > 255
+#error "Too many EEPROM slots. Reduce ASKRmt_EEPROM_END - ASKRmt_EEPROM_START."
+#endif
+#endif
+
+/* Size of the open-addressing hash table of the index. It is a power of 2 and 
+   at least 1.5 times the number of slots to keep the probe sequences short.   */
+#if SLOT_COUNT * 3 / 2 <= 16
+#define INDEX_TABLE_SIZE 16
+#elif SLOT_COUNT * 3 / 2 <= 32
+#define INDEX_TABLE_SIZE 32
+#elif SLOT_COUNT * 3 / 2 <= 64
+#define INDEX_TABLE_SIZE 64
+#elif SLOT_COUNT * 3 / 2 <= 128
+#define INDEX_TABLE_SIZE 128
+#else
+#define INDEX_TABLE_SIZE 256
+#endif
+
+#define INDEX_RAM_SIZE (SLOT_COUNT * 3 + INDEX_TABLE_SIZE + (SLOT_COUNT + 7) / 8)
+
+#if (INDEX_RAM_SIZE <= ASKRmt_INDEX_RAM_BUDGET) && !defined(ASKRmt_SORTEDSTORE)
+#define USE_INDEX
+#endif
+
+#if defined(ASKRmt_STORAGE_I2CEEPROM) && !defined(ASKRmt_DEFERREDVALIDATION) && !defined(USE_INDEX) && defined(__AVR__)
+#error "The I2C EEPROM can not be read in the RF signal pin interrupt. Define ASKRmt_DEFERREDVALIDATION or increase ASKRmt_INDEX_RAM_BUDGET."
+#endif
+
+#if defined(ASKRmt_JOURNALEDSTORE) && !defined(USE_INDEX)
+#error "The journaled store keeps the saved codes in the index. Increase ASKRmt_INDEX_RAM_BUDGET."
+#endif
+
+#if defined(ASKRmt_SORTEDSTORE) && !defined(ASKRmt_DEFERREDVALIDATION)
+#error "The sorted store is changed in several blocks and can not be read in the RF signal pin interrupt. Define ASKRmt_DEFERREDVALIDATION."
+#endif
+
+#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) && !defined(ASKRmt_JOURNALEDSTORE) && !defined(ASKRmt_SORTEDSTORE)
+#define USE_GENERATION
+#endif
+
+#if (ASKRmt_EEPROMWRITEQUEUE_SIZE > 0) && defined(ASKRmt_HAL_STORAGEREADYINTERRUPT)
+#define USE_WRITEQUEUE
+#endif
+
+#ifdef USE_WRITEQUEUE
+
+/* One queued EEPROM byte write.                                               */
+typedef struct
+{
+	uint16_t Address;
+	uint8_t  Value;
+} StorageWrite;
+
+/* Ring of the EEPROM writes that are not started yet. The main program adds 
+   writes at the tail and the EEPROM ready interrupt starts the write at 
+   WriteHead and removes it. Writes are started in the order they are added, 
+   so the 3rd byte of a saved slot is still written after the first 2 bytes.   */
+StorageWrite     WriteQueue[ASKRmt_EEPROMWRITEQUEUE_SIZE];
+volatile uint8_t WriteHead = 0, WriteCount = 0;
+volatile uint8_t StorageReads = 0; // EEPROM reads in progress, a lookup of the RF interrupt can nest in one
+
+/* Starts the oldest queued write. The EEPROM must be ready.                   */
+void StartQueuedWrite(void)
+{
+	if (!WriteCount)
+	{
+		ASKRmt_HAL_STORAGEREADYINTERRUPTOFF();
+		return;
+	}
+	StorageWrite *w = &WriteQueue[WriteHead];
+	ASKRmt_HAL_STORAGEWRITE(w->Address, w->Value); // does not wait because the EEPROM is ready
+	WriteHead = (WriteHead + 1) & (ASKRmt_EEPROMWRITEQUEUE_SIZE - 1);
+	if (!--WriteCount) ASKRmt_HAL_STORAGEREADYINTERRUPTOFF();
+}
+
+#endif
+
+void ASKRmt_EEPROMReadyInterrupt(void)
+{
+	#ifdef USE_WRITEQUEUE
+	StartQueuedWrite();
+	#endif
+}
+
+bool ASKRmt_IsEEPROMBusy(void)
+{
+	#ifdef USE_WRITEQUEUE
+	if (WriteCount) return true;
+	#endif
+	return !ASKRmt_HAL_STORAGEISREADY();
+}
+
+uint8_t ASKRmt_PendingEEPROMWrites(void)
+{
+	#ifdef USE_WRITEQUEUE
+	return WriteCount;
+	#else
+	return 0;
+	#endif
+}
+
+void ASKRmt_FlushEEPROMWrites(void)
+{
+	while (ASKRmt_IsEEPROMBusy())
+	{
+		#ifdef USE_WRITEQUEUE
+		// start the writes here too, so flushing does not depend on the interrupts being enabled
+		ASKRmt_HAL_ATOMIC
+		{
+			if (ASKRmt_HAL_STORAGEISREADY()) StartQueuedWrite();
+		}
+		#endif
+	}
+}
+
+/* Writes a byte of the EEPROM. If the write queue is used, the write is 
+   queued and this function only waits if the queue is full.                   */
+void WriteStorage(uint16_t addr, uint8_t val)
+{
+	#ifdef USE_WRITEQUEUE
+	while (1)
+	{
+		bool queued = false;
+		ASKRmt_HAL_ATOMIC
+		{
+			if (WriteCount < ASKRmt_EEPROMWRITEQUEUE_SIZE)
+			{
+				StorageWrite *w = &WriteQueue[(WriteHead + WriteCount) & (ASKRmt_EEPROMWRITEQUEUE_SIZE - 1)];
+				w->Address = addr;
+				w->Value = val;
+				WriteCount++;
+				ASKRmt_HAL_STORAGEREADYINTERRUPTON();
+				queued = true;
+			}
+			else if (ASKRmt_HAL_STORAGEISREADY())
+				StartQueuedWrite(); // the queue is full, free an entry even if the interrupts are disabled
+		}
+		if (queued) return;
+	}
+	#else
+	ASKRmt_HAL_STORAGEWRITE(addr, val);
+	#endif
+}
+
+/* Reads a byte of the EEPROM. The newest queued write of the address is 
+   returned if there is one. Writes that are removed from the queue are 
+   already started and the EEPROM read waits until they are finished. The 
+   EEPROM ready interrupt is disabled during the read, so it can not start a 
+   queued write between the address load and the read. The other interrupts 
+   stay enabled while the read waits, and the interrupt is enabled again 
+   after the outermost read.                                                   */
+uint8_t ReadStorage(uint16_t addr)
+{
+	#ifdef USE_WRITEQUEUE
+	bool found = false;
+	uint8_t val = 0;
+	ASKRmt_HAL_ATOMIC
+	{
+		for (uint8_t i = 0; i < WriteCount; i++)
+		{
+			StorageWrite *w = &WriteQueue[(WriteHead + i) & (ASKRmt_EEPROMWRITEQUEUE_SIZE - 1)];
+			if (w->Address == addr)
+			{
+				val = w->Value;
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			ASKRmt_HAL_STORAGEREADYINTERRUPTOFF();
+			StorageReads++;
+		}
+	}
+	if (found) return val;
+	val = ASKRmt_HAL_STORAGEREAD(addr);
+	ASKRmt_HAL_ATOMIC
+	{
+		// the ready interrupt is the only one that removes writes, so the queue is still there
+		if (!--StorageReads && WriteCount) ASKRmt_HAL_STORAGEREADYINTERRUPTON();
+	}
+	return val;
+	#else
+	return ASKRmt_HAL_STORAGEREAD(addr);
+	#endif
+}
+
+/* Reads "n" bytes of the storage. Only the main program queues writes, so the 
+   queue can not get new writes while a block is read.                         */
+void ReadStorageBlock(uint16_t addr, void *dst, uint16_t n)
+{
+	#ifdef USE_WRITEQUEUE
+	if (WriteCount) // the block may have queued writes
+	{
+		for (uint16_t i = 0; i < n; i++) ((uint8_t *)dst)[i] = ReadStorage(addr + i);
+		return;
+	}
+	#endif
+	ASKRmt_HAL_STORAGEREADBLOCK(dst, addr, n);
+}
+
+/* Writes "n" bytes of the storage in the order of their addresses. The 
+   storage only writes the changed bytes. The write queue writes all of them 
+   because comparing would wait for the write in progress.                     */
+void WriteStorageBlock(uint16_t addr, const void *src, uint16_t n)
+{
+	#ifdef USE_WRITEQUEUE
+	for (uint16_t i = 0; i < n; i++) WriteStorage(addr + i, ((const uint8_t *)src)[i]);
+	#else
+	ASKRmt_HAL_STORAGEWRITEBLOCK(src, addr, n);
+	#endif
+}
+
+#ifdef ASKRmt_SORTEDSTORE
+/* Sorted store of the saved codes. It accesses the storage through the write 
+   queue like the other stores.                                                */
+ASKRmt_Database Database = { ASKRmt_EEPROM_START, SORTED_LEAVES, 0, ReadStorageBlock, WriteStorageBlock };
+#endif
+
+#ifdef USE_GENERATION
+
+/* Bits 1-3 of the 3rd byte of a saved remote control are the generation that 
+   it was saved in. Only the codes of the current generation are saved, so 
+   deleting all of the remote controls only moves to the next generation.      */
+#define GENERATION_MASK  0x0E
+#define GENERATION_SHIFT 1
+
+#if (ASKRmt_EEPROM_GENERATION >= ASKRmt_EEPROM_START) && (ASKRmt_EEPROM_GENERATION <= ASKRmt_EEPROM_END)
+#error "ASKRmt_EEPROM_GENERATION must be outside ASKRmt_EEPROM_START..ASKRmt_EEPROM_END."
+#endif
+
+uint8_t Generation; // current generation in bits 1-3
+
+#endif
+
+bool    StorageOpened = false;
+
+/* Returns true if the 3rd byte of a slot marks a saved code.                  */
+bool IsSlotUsed(uint8_t code2)
+{
+	if (0xFF == code2) return false;
+	#ifdef USE_GENERATION
+	return ((code2 & GENERATION_MASK) == Generation);
+	#else
+	return true;
+	#endif
+}
+
+#ifdef ASKRmt_TRITPACKEDSTORE
+
+/* Packs a FixCode remote control into the 2 bytes of a slot: the 8 address 
+   trits of the first 2 bytes of the code in base 3 (13 bits), the low byte 
+   first, and the generation in bits 5-7 of the 2nd byte, which is written 
+   last. The packed address is at most 6560, so the 2nd byte of a saved slot 
+   is never 0xFF. Returns false if the code is a LearningCode remote control 
+   or its address has a pair of bits 10.                                       */
+bool PackSlot(const uint8_t *code, uint8_t *packed)
+{
+	uint8_t high, low, ones;
+	if (!(code[2] & 1)) return false;
+	if (!ASKRmt_DecodeTritByte(code[0], &high, &ones) || !ASKRmt_DecodeTritByte(code[1], &low, &ones)) return false;
+	uint16_t address = high * 81 + low;
+	packed[0] = (uint8_t)address;
+	packed[1] = (uint8_t)(address >> 8) | ((code[2] & GENERATION_MASK) << 4);
+	return true;
+}
+
+/* Returns the 3rd byte of the code of a slot from its last byte.              */
+uint8_t SlotCode2(uint8_t last)
+{
+	if (0xFF == last) return 0xFF;
+	return ((last >> 4) & GENERATION_MASK) | 1; // a FixCode remote control
+}
+
+#else
+
+uint8_t SlotCode2(uint8_t last)
+{
+	return last;
+}
+
+#endif
+
+/* Reads the code of a slot from the EEPROM. A packed slot is unpacked into 
+   the 3 bytes of the code, and a slot that is not a packed address is free.   */
+void ReadSlotCode(uint8_t slot, uint8_t *code)
+{
+	#ifdef ASKRmt_TRITPACKEDSTORE
+	uint8_t packed[2];
+	ReadStorageBlock(ASKRmt_EEPROM_START + slot * 2, packed, 2);
+	ASKRmt_TriState trits = { (uint16_t)(((packed[1] & 0x1F) << 8) | packed[0]), 0, 0 };
+	if ((0xFF == packed[1]) || (trits.Address > 6560))
+	{
+		code[0] = code[1] = code[2] = 0xFF;
+		return;
+	}
+	ASKRmt_EncodeTriState(&trits, code);
+	code[2] = SlotCode2(packed[1]);
+	#else
+	ReadStorageBlock(ASKRmt_EEPROM_START + slot * 3, code, 3);
+	#endif
+}
+
+/* Writes a code that is saved with its generation to a slot of the EEPROM. 
+   The last byte of the slot is written last, so the slot is saved when it is 
+   written.                                                                    */
+void WriteSlotCode(uint8_t slot, const uint8_t *code)
+{
+	#ifdef ASKRmt_TRITPACKEDSTORE
+	uint8_t packed[2];
+	PackSlot(code, packed);
+	WriteStorageBlock(ASKRmt_EEPROM_START + slot * 2, packed, 2);
+	#else
+	WriteStorageBlock(ASKRmt_EEPROM_START + slot * 3, code, 3);
+	#endif
+}
+
+/* Returns true if the code of a slot matches the received data. FixCode remote 
+   controls are matched by the first 2 bytes, LearningCode remote controls also 
+   by the most significant nibble of the 3rd byte, and keys by all 3 bytes.    */
+bool IsCodeMatch(const uint8_t *code, const uint8_t *data)
+{
+	if (!IsSlotUsed(code[2])) return false;
+	if (code[0] != data[0]) return false;
+	if (code[1] != data[1]) return false;
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	// least significant nibble of 3rd byte is the remote control type (0:LearningCode, 1:FixCode)
+	if (code[2] & 1) return true; // if remote control is code fix don't compare third byte
+	return ((code[2] & 0xF0) == (data[2] & 0xF0));
+	#else
+	return (code[2] == data[2]);
+	#endif
+}
+
+#ifdef USE_INDEX
+
+/* The index keeps a copy of the EEPROM slots, a hash table of the occupied 
+   slots keyed by the code address and a bitmap of the free slots. It is built 
+   once from the EEPROM and the EEPROM is only written afterwards. Free slots 
+   and codes of the old generations are 0xFF in the 3rd byte of the copy.      */
+uint8_t IndexCodes[SLOT_COUNT][3];
+uint8_t IndexTable[INDEX_TABLE_SIZE]; // slot number + 1, 0 is an empty entry
+uint8_t IndexFreeSlots[(SLOT_COUNT + 7) / 8];
+
+/* Hash table position of a code. Remote controls are hashed by the 16-bit 
+   address only because FixCode remote controls ignore the 3rd byte.           */
+uint8_t IndexHash(const uint8_t *data)
+{
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	return (uint8_t)(data[0] + data[1] * 7) & (INDEX_TABLE_SIZE - 1);
+	#else
+	return (uint8_t)(data[0] + data[1] * 7 + data[2] * 31) & (INDEX_TABLE_SIZE - 1);
+	#endif
+}
+
+void IndexInsert(uint8_t slot)
+{
+	uint8_t i = IndexHash(IndexCodes[slot]);
+	while (IndexTable[i]) i = (i + 1) & (INDEX_TABLE_SIZE - 1);
+	IndexTable[i] = slot + 1;
+	IndexFreeSlots[slot / 8] &= ~(1 << (slot % 8));
+}
+
+void IndexRemove(uint8_t slot)
+{
+	uint8_t i = IndexHash(IndexCodes[slot]);
+	while (IndexTable[i] != slot + 1) i = (i + 1) & (INDEX_TABLE_SIZE - 1);
+	// shift the following entries of the probe sequence back to fill the gap
+	uint8_t j = i;
+	while (1)
+	{
+		j = (j + 1) & (INDEX_TABLE_SIZE - 1);
+		if (!IndexTable[j]) break;
+		uint8_t k = IndexHash(IndexCodes[IndexTable[j] - 1]);
+		// the entry stays if its home position is cyclically in (i, j]
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) continue;
+		IndexTable[i] = IndexTable[j];
+		i = j;
+	}
+	IndexTable[i] = 0;
+	IndexFreeSlots[slot / 8] |= (1 << (slot % 8));
+	IndexCodes[slot][2] = 0xFF;
+}
+
+/* Builds the hash table and the free slots bitmap from the copy of the slots. */
+void IndexSlots(void)
+{
+	for (uint16_t i = 0; i < INDEX_TABLE_SIZE; i++) IndexTable[i] = 0;
+	for (uint8_t i = 0; i < sizeof(IndexFreeSlots); i++) IndexFreeSlots[i] = 0;
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+	{
+		if (IsSlotUsed(IndexCodes[slot][2]))
+			IndexInsert(slot);
+		else
+		{
+			IndexCodes[slot][2] = 0xFF;
+			IndexFreeSlots[slot / 8] |= (1 << (slot % 8));
+		}
+	}
+}
+
+/* Frees all of the slots of the index.                                        */
+void ClearIndex(void)
+{
+	for (uint16_t i = 0; i < INDEX_TABLE_SIZE; i++) IndexTable[i] = 0;
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+	{
+		IndexCodes[slot][2] = 0xFF;
+		IndexFreeSlots[slot / 8] |= (1 << (slot % 8));
+	}
+}
+
+#ifndef ASKRmt_JOURNALEDSTORE
+void BuildIndex(void)
+{
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++) ReadSlotCode(slot, IndexCodes[slot]);
+	IndexSlots();
+}
+#endif
+
+#endif
+
+#ifdef ASKRmt_JOURNALEDSTORE
+
+/* The saved codes are the index. Each save or delete appends a record of the 
+   new content of a slot to the active bank, so the writes move through the 
+   bank instead of rewriting the same bytes. When the bank is full, the saved 
+   codes are written to the other bank, which becomes the active bank when 
+   its header is written. At startup the records of the bank with the newer 
+   sequence number are applied in order until the first invalid record, so a 
+   record that is not completely written is ignored. The CRC also rejects 
+   records with bytes that are damaged in other ways.                          */
+uint16_t JournalBank;     // address of the active bank
+uint8_t  JournalSequence; // sequence number of the active bank
+uint8_t  JournalNext;     // number of records of the active bank
+
+/* CRC-8 (polynomial 0x07) of the first 4 bytes of a record starting from the 
+   sequence number of the bank, so records that are left from the previous 
+   use of a bank are invalid.                                                  */
+uint8_t JournalCheck(uint8_t sequence, const uint8_t *record)
+{
+	uint8_t crc = sequence;
+	for (uint8_t i = 0; i < JOURNAL_RECORD_SIZE - 1; i++)
+	{
+		crc ^= record[i];
+		for (uint8_t b = 0; b < 8; b++) crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+	}
+	return crc;
+}
+
+bool IsJournalRecordValid(const uint8_t *record)
+{
+	if (record[0] >= SLOT_COUNT) return false;
+	return (record[4] == JournalCheck(JournalSequence, record));
+}
+
+uint16_t JournalRecordAddress(uint8_t n)
+{
+	return JournalBank + 2 + n * JOURNAL_RECORD_SIZE;
+}
+
+/* Erases the slot byte of the record after the last record of the active 
+   bank, so the startup stops there even if the rest of that record is valid 
+   by chance.                                                                  */
+void EndJournal(void)
+{
+	if (JournalNext >= JOURNAL_RECORDS) return;
+	uint16_t addr = JournalRecordAddress(JournalNext);
+	if (0xFF != ReadStorage(addr)) WriteStorage(addr, 0xFF);
+}
+
+/* Writes a record after the last record of the active bank. Its slot byte is 
+   erased by EndJournal, so it is written last and the record stays invalid 
+   until it is completely written.                                             */
+void WriteJournalRecord(uint8_t slot, const uint8_t *code)
+{
+	uint8_t record[JOURNAL_RECORD_SIZE] = { slot, code[0], code[1], code[2], 0 };
+	record[4] = JournalCheck(JournalSequence, record);
+	uint16_t addr = JournalRecordAddress(JournalNext++);
+	WriteStorageBlock(addr + 1, record + 1, JOURNAL_RECORD_SIZE - 1);
+	WriteStorage(addr, slot);
+}
+
+/* Writes the saved codes of the index to the other bank and activates it by 
+   writing its header after them. If the power is lost before the header is 
+   written, the previous bank stays active.                                    */
+void CompactJournal(void)
+{
+	JournalBank = (ASKRmt_EEPROM_START == JournalBank) ? ASKRmt_EEPROM_START + JOURNAL_BANK_SIZE : ASKRmt_EEPROM_START;
+	JournalSequence++;
+	JournalNext = 0;
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+		if (0xFF != IndexCodes[slot][2])
+			WriteJournalRecord(slot, IndexCodes[slot]);
+	EndJournal();
+	uint8_t header[2] = { JournalSequence, (uint8_t)~JournalSequence };
+	WriteStorageBlock(JournalBank, header, 2);
+}
+
+/* Appends the new content of a slot to the journal.                           */
+void AppendJournal(uint8_t slot, const uint8_t *code)
+{
+	if (JournalNext >= JOURNAL_RECORDS) CompactJournal();
+	WriteJournalRecord(slot, code);
+	EndJournal();
+}
+
+/* Reads the header of a bank. Returns false if it is not completely 
+   written.                                                                    */
+bool ReadJournalHeader(uint16_t bank, uint8_t *sequence)
+{
+	uint8_t header[2];
+	ReadStorageBlock(bank, header, 2);
+	*sequence = header[0];
+	return (header[0] == (uint8_t)~header[1]);
+}
+
+/* Selects the active bank and applies its records to the copy of the slots 
+   in one pass. If no bank has a header, an empty bank is written.             */
+void OpenJournal(void)
+{
+	uint8_t a, b;
+	bool isA = ReadJournalHeader(ASKRmt_EEPROM_START, &a);
+	bool isB = ReadJournalHeader(ASKRmt_EEPROM_START + JOURNAL_BANK_SIZE, &b);
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++) IndexCodes[slot][2] = 0xFF;
+	if (!isA && !isB)
+	{
+		// new store, compacting the empty slots writes the first bank
+		JournalBank = ASKRmt_EEPROM_START + JOURNAL_BANK_SIZE;
+		JournalSequence = 0xFF;
+		CompactJournal();
+		return;
+	}
+	if (isA && (!isB || ((int8_t)(a - b) > 0))) // the sequence number wraps around
+	{
+		JournalBank = ASKRmt_EEPROM_START;
+		JournalSequence = a;
+	}
+	else
+	{
+		JournalBank = ASKRmt_EEPROM_START + JOURNAL_BANK_SIZE;
+		JournalSequence = b;
+	}
+	uint8_t record[JOURNAL_RECORD_SIZE];
+	for (JournalNext = 0; JournalNext < JOURNAL_RECORDS; JournalNext++)
+	{
+		ReadStorageBlock(JournalRecordAddress(JournalNext), record, JOURNAL_RECORD_SIZE);
+		if (!IsJournalRecordValid(record)) break;
+		IndexCodes[record[0]][0] = record[1];
+		IndexCodes[record[0]][1] = record[2];
+		IndexCodes[record[0]][2] = record[3];
+	}
+	EndJournal(); // the power may have been lost while the slot byte was erased
+}
+
+#endif
+
+/* Reads the generation and builds the index, reads the journal or opens the 
+   sorted store. An erased generation byte is the generation 0, which is the 
+   generation bits of the remote controls that were saved before the 
+   generation byte, so they stay saved without being rewritten.                */
+void OpenStorage(void)
+{
+	#ifdef USE_GENERATION
+	uint8_t g = ReadStorage(ASKRmt_EEPROM_GENERATION);
+	if (0xFF == g) g = 0;
+	Generation = (g << GENERATION_SHIFT) & GENERATION_MASK;
+	#endif
+	#ifdef ASKRmt_JOURNALEDSTORE
+	OpenJournal();
+	IndexSlots();
+	#elif defined(ASKRmt_SORTEDSTORE)
+	ASKRmt_DBOpen(&Database);
+	#elif defined(USE_INDEX)
+	BuildIndex();
+	#endif
+	StorageOpened = true;
+}
+
+/* Returns the slot number of the saved code that matches the received data or 
+   NO_SLOT. The code of the slot is copied to the "code" array.                */
+SlotNumber FindSlot(const uint8_t *data, uint8_t *code)
+{
+	if (!StorageOpened) OpenStorage();
+	#ifdef USE_INDEX
+	for (uint8_t i = IndexHash(data); IndexTable[i]; i = (i + 1) & (INDEX_TABLE_SIZE - 1))
+	{
+		uint8_t slot = IndexTable[i] - 1;
+		if (IsCodeMatch(IndexCodes[slot], data))
+		{
+			code[0] = IndexCodes[slot][0];
+			code[1] = IndexCodes[slot][1];
+			code[2] = IndexCodes[slot][2];
+			return slot;
+		}
+	}
+	#elif defined(ASKRmt_SORTEDSTORE)
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	return ASKRmt_DBFind(&Database, data, 2, IsCodeMatch, code); // the codes of a remote control address are adjacent
+	#else
+	return ASKRmt_DBFind(&Database, data, 3, IsCodeMatch, code);
+	#endif
+	#else
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+	{
+		ReadSlotCode(slot, code);
+		if (IsCodeMatch(code, data)) return slot;
+	}
+	#endif
+	return NO_SLOT;
+}
+
+/* Saves the code to a free slot. Returns false if the EEPROM is full.         */
+bool StoreCode(const uint8_t *code)
+{
+	if (!StorageOpened) OpenStorage();
+	#ifdef ASKRmt_SORTEDSTORE
+	if (!ASKRmt_DBInsert(&Database, code)) return false;
+	InvalidateQueuedLookups(); // the codes after the new code move to other slots
+	return true;
+	#else
+	#ifdef ASKRmt_TRITPACKEDSTORE
+	uint8_t packed[2];
+	if (!PackSlot(code, packed)) return false; // a LearningCode remote control or an invalid address
+	#endif
+	uint8_t slot = NO_SLOT;
+	#ifdef USE_INDEX
+	for (uint8_t i = 0; i < sizeof(IndexFreeSlots); i++)
+		if (IndexFreeSlots[i])
+		{
+			slot = i * 8;
+			for (uint8_t bits = IndexFreeSlots[i]; !(bits & 1); bits >>= 1) slot++;
+			break;
+		}
+	if (slot >= SLOT_COUNT) return false;
+	#else
+	for (uint8_t i = 0; i < SLOT_COUNT; i++)
+		if (!IsSlotUsed(SlotCode2(ReadStorage(ASKRmt_EEPROM_START + i * SLOT_SIZE + SLOT_SIZE - 1))))
+		{
+			slot = i;
+			break;
+		}
+	if (NO_SLOT == slot) return false;
+	#endif
+	uint8_t code2 = code[2];
+	#ifdef USE_GENERATION
+	code2 |= Generation;
+	#endif
+	#ifdef ASKRmt_JOURNALEDSTORE
+	AppendJournal(slot, code);
+	#else
+	uint8_t saved[3] = { code[0], code[1], code2 };
+	WriteSlotCode(slot, saved);
+	#endif
+	#ifdef USE_INDEX
+	IndexCodes[slot][0] = code[0];
+	IndexCodes[slot][1] = code[1];
+	IndexCodes[slot][2] = code2;
+	ASKRmt_HAL_ATOMIC IndexInsert(slot); // the ISR may look up codes
+	#endif
+	return true;
+	#endif
+}
+
+/* Frees a slot.                                                               */
+void EraseSlot(SlotNumber slot)
+{
+	#ifdef ASKRmt_JOURNALEDSTORE
+	static const uint8_t erased[3] = { 0xFF, 0xFF, 0xFF };
+	AppendJournal(slot, erased);
+	#elif defined(ASKRmt_SORTEDSTORE)
+	ASKRmt_DBDelete(&Database, slot);
+	#else
+	WriteStorage(ASKRmt_EEPROM_START + slot * SLOT_SIZE + SLOT_SIZE - 1, 0xFF);
+	#endif
+	#ifdef USE_INDEX
+	ASKRmt_HAL_ATOMIC IndexRemove(slot); // the ISR may look up codes
+	#endif
+	InvalidateQueuedLookups();
+}
+
+/* Frees all of the slots. The journaled store writes an empty bank and the 
+   sorted store writes 0 used leaves. Remote controls are freed by writing the 
+   next generation only. The codes that are left from 8 generations ago would 
+   be saved again in the next generation, so they are erased before it.        */
+void EraseAllSlots(void)
+{
+	if (!StorageOpened) OpenStorage();
+	#ifdef ASKRmt_JOURNALEDSTORE
+	ASKRmt_HAL_ATOMIC ClearIndex(); // the ISR may look up codes
+	CompactJournal(); // writes an empty bank
+	InvalidateQueuedLookups();
+	#elif defined(ASKRmt_SORTEDSTORE)
+	ASKRmt_DBClear(&Database);
+	InvalidateQueuedLookups();
+	#elif defined(USE_GENERATION)
+	uint8_t next = (Generation + (1 << GENERATION_SHIFT)) & GENERATION_MASK;
+	for (uint16_t addr = ASKRmt_EEPROM_START + SLOT_SIZE - 1; addr <= ASKRmt_EEPROM_END; addr += SLOT_SIZE)
+	{
+		uint8_t code2 = SlotCode2(ReadStorage(addr));
+		if ((0xFF != code2) && ((code2 & GENERATION_MASK) == next)) WriteStorage(addr, 0xFF);
+	}
+	WriteStorage(ASKRmt_EEPROM_GENERATION, next >> GENERATION_SHIFT);
+	ASKRmt_HAL_ATOMIC // the ISR may look up codes
+	{
+		Generation = next;
+		#ifdef USE_INDEX
+		ClearIndex();
+		#endif
+	}
+	InvalidateQueuedLookups();
+	#elif defined(USE_INDEX)
+	for (uint8_t slot = 0; slot < SLOT_COUNT; slot++)
+		if (0xFF != IndexCodes[slot][2])
+			EraseSlot(slot);
+	#else
+	for (uint16_t addr = ASKRmt_EEPROM_START; addr < ASKRmt_EEPROM_END; addr += 3)
+		if (0xFF != ReadStorage(addr + 2))
+			WriteStorage(addr + 2, 0xFF); // keys, so the slots have 3 bytes
+	InvalidateQueuedLookups();
+	#endif
+}
+
+/* Copies the code of a slot to the "code" array. Returns false if the slot 
+   number is out of range.                                                     */
+bool ReadSlot(SlotNumber slot, uint8_t *code)
+{
+	if (slot >= SLOT_COUNT) return false;
+	if (!StorageOpened) OpenStorage();
+	#ifdef USE_INDEX
+	code[0] = IndexCodes[slot][0];
+	code[1] = IndexCodes[slot][1];
+	code[2] = IndexCodes[slot][2];
+	#elif defined(ASKRmt_SORTEDSTORE)
+	ASKRmt_DBReadSlot(&Database, slot, code);
+	#else
+	ReadSlotCode(slot, code);
+	#endif
+	#ifdef USE_GENERATION
+	if (IsSlotUsed(code[2]))
+		code[2] &= ~GENERATION_MASK;
+	else
+		code[2] = 0xFF; // a code of an old generation is free
+	#endif
+	return true;
+}
+
+uint16_t ASKRmt_GetSlotCount(void)
+{
+	return SLOT_COUNT;
+}
+
+#ifdef ASKRmt_SORTEDSTORE
+
+bool    ImportStarted; // a code is imported
+uint8_t ImportLast[3]; // last imported code
+
+/* Deletes the saved codes that are greater than the last imported code and 
+   smaller than "code", or all of them if "code" is 0. The saved codes that 
+   are not greater than the last imported code are the imported codes, so the 
+   codes that are not imported are deleted when the import passes them. 
+   Returns true if "code" is saved.                                            */
+bool DeleteUnimportedCodes(const uint8_t *code)
+{
+	uint8_t key[3] = { 0, 0, 0 }, saved[3];
+	if (ImportStarted)
+	{
+		key[0] = ImportLast[0];
+		key[1] = ImportLast[1];
+		key[2] = ImportLast[2];
+		for (int8_t i = 2; (i >= 0) && !++key[i]; i--); // the next code
+	}
+	while (1)
+	{
+		SlotNumber slot = ASKRmt_DBFirst(&Database, key, saved);
+		if (NO_SLOT == slot) return false;
+		if (code)
+		{
+			int8_t c = ASKRmt_DBCompare(saved, code);
+			if (0 == c) return true;
+			if (c > 0) return false;
+		}
+		EraseSlot(slot);
+	}
+}
+
+#else
+
+uint16_t ImportSlot; // slot of the next imported code
+
+/* Writes the bytes of a slot that differ from the storage in the order of 
+   their addresses.                                                            */
+void UpdateSlotBytes(uint16_t addr, const uint8_t *code)
+{
+	uint8_t old[SLOT_SIZE];
+	ReadStorageBlock(addr, old, SLOT_SIZE);
+	for (uint8_t i = 0; i < SLOT_SIZE; i++)
+		if (old[i] != code[i]) WriteStorage(addr + i, code[i]);
+}
+
+/* Saves "code" to a slot or frees the slot if the 3rd byte of "code" is 0xFF. 
+   Nothing is written if the slot already has the code.                        */
+void SetSlot(SlotNumber slot, const uint8_t *code)
+{
+	uint8_t current[3], saved[3] = { code[0], code[1], code[2] };
+	if (!ReadSlot(slot, current)) return;
+	if (0xFF == code[2])
+	{
+		if (0xFF != current[2]) EraseSlot(slot);
+		return;
+	}
+	#ifdef USE_GENERATION
+	saved[2] &= ~GENERATION_MASK;
+	#endif
+	if ((current[0] == saved[0]) && (current[1] == saved[1]) && (current[2] == saved[2])) return;
+	#ifdef USE_GENERATION
+	saved[2] |= Generation;
+	#endif
+	#ifdef ASKRmt_JOURNALEDSTORE
+	AppendJournal(slot, saved);
+	#elif defined(ASKRmt_TRITPACKEDSTORE)
+	uint8_t packed[2];
+	PackSlot(saved, packed);
+	UpdateSlotBytes(ASKRmt_EEPROM_START + slot * 2, packed);
+	#else
+	UpdateSlotBytes(ASKRmt_EEPROM_START + slot * 3, saved);
+	#endif
+	#ifdef USE_INDEX
+	ASKRmt_HAL_ATOMIC // the ISR may look up codes
+	{
+		if (0xFF != current[2]) IndexRemove(slot);
+		IndexCodes[slot][0] = saved[0];
+		IndexCodes[slot][1] = saved[1];
+		IndexCodes[slot][2] = saved[2];
+		IndexInsert(slot);
+	}
+	#endif
+	InvalidateQueuedLookups();
+}
+
+#endif
+
+void ASKRmt_BeginImport(void)
+{
+	if (!StorageOpened) OpenStorage();
+	#ifdef ASKRmt_SORTEDSTORE
+	ImportStarted = false;
+	#else
+	ImportSlot = 0;
+	#endif
+}
+
+bool ASKRmt_ImportCode(const uint8_t *code)
+{
+	if (0xFF == code[2]) return false; // a free slot
+	#ifdef ASKRmt_SORTEDSTORE
+	if (ImportStarted && (ASKRmt_DBCompare(code, ImportLast) <= 0)) return false;
+	if (!DeleteUnimportedCodes(code))
+	{
+		if (!ASKRmt_DBInsert(&Database, code)) return false;
+		InvalidateQueuedLookups();
+	}
+	ImportLast[0] = code[0];
+	ImportLast[1] = code[1];
+	ImportLast[2] = code[2];
+	ImportStarted = true;
+	#else
+	if (ImportSlot >= SLOT_COUNT) return false;
+	#ifdef ASKRmt_TRITPACKEDSTORE
+	uint8_t packed[2];
+	if (!PackSlot(code, packed)) return false; // a LearningCode remote control or an invalid address
+	#endif
+	SetSlot(ImportSlot++, code);
+	#endif
+	return true;
+}
+
+void ASKRmt_EndImport(void)
+{
+	#ifdef ASKRmt_SORTEDSTORE
+	DeleteUnimportedCodes(0);
+	#else
+	static const uint8_t erased[3] = { 0xFF, 0xFF, 0xFF };
+	for (; ImportSlot < SLOT_COUNT; ImportSlot++) SetSlot(ImportSlot, erased);
+	#endif
+}
+
+#endif
+
+void ASKRmt_Init(void)
+{
+	#ifdef ASKRmt_INPUTCAPTURE
+	ASKRmt_HAL_CAPTURESTART();
+	#endif
+	#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+	OpenStorage();
+	#endif
+}
+
+#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+
+bool CheckIsRemoteSaved(ReceivedFrame *frame)
+{
+	uint8_t code[3];
+	frame->Slot = FindSlot(FrameCode(frame), code);
+	if (NO_SLOT == frame->Slot) return false;
+	frame->IsFixCode = (code[2] & 1);
+	return true;
 }
 
 int8_t ASKRmt_GetKeyIfRemoteSaved(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved)
 		{
-			if (IsRemoteFixCode)
-				return GetFixCodeKey();
+			if (frame->IsFixCode)
+				return GetFixCodeKey(FrameCode(frame));
 			else
-				return (ReceivedData[2] & 0xF);
+				return GetLearningCodeKey(frame);
 		}
 	}
 	return -1;
@@ -210,66 +1671,63 @@ int8_t ASKRmt_GetKeyIfRemoteSaved(void)
 
 int8_t ASKRmt_PickKeyIfRemoteSaved(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved)
 		{
 			int8_t r;
-			if (IsRemoteFixCode)
-				r = GetFixCodeKey();
+			if (frame->IsFixCode)
+				r = GetFixCodeKey(FrameCode(frame));
 			else
-				r = ReceivedData[2] & 0xF;
-			DataReceived = false;
+				r = GetLearningCodeKey(frame);
+			PopHeadFrame();
 			return r;
 		}
-		DataReceived = false;
+		PopHeadFrame();
 	}
 	return -1;
 }
 
-bool SaveRemote(bool isFixCode)
+bool SaveRemote(ReceivedFrame *frame, bool isFixCode)
 {
-	uint8_t val;
-	for (RemoteCodeAddr = ASKRmt_EEPROM_START; RemoteCodeAddr < ASKRmt_EEPROM_END; RemoteCodeAddr += 3)
-	{
-		val = eeprom_read_byte((const uint8_t *)(RemoteCodeAddr + 2));
-		if (0xFF == val) {
-			eeprom_write_byte((uint8_t *)RemoteCodeAddr, ReceivedData[0]);
-			eeprom_write_byte((uint8_t *)(RemoteCodeAddr + 1), ReceivedData[1]);
-			if (isFixCode) 
-				eeprom_write_byte((uint8_t *)(RemoteCodeAddr + 2), 1);
-			else
-				eeprom_write_byte((uint8_t *)(RemoteCodeAddr + 2), ReceivedData[2] & 0xF0);
-			return true;
-		}
-	}
-	return false;
+	const uint8_t *data = FrameCode(frame);
+	uint8_t code[3];
+	code[0] = data[0];
+	code[1] = data[1];
+	if (isFixCode) 
+		code[2] = 1;
+	else
+		code[2] = data[2] & 0xF0;
+	return StoreCode(code);
 }
 
 bool ASKRmt_SaveRemote(bool isFixCode)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved) return false;
-		return SaveRemote(isFixCode);
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved) return false;
+		return SaveRemote(frame, isFixCode);
 	}
 	return false;
 }
 
 bool ASKRmt_PickDataAndSaveRemote(bool isFixCode)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved)
 		{
-			DataReceived = false;
+			PopHeadFrame();
 			return false;
 		}
-		bool r = SaveRemote(isFixCode);
-		DataReceived = false;
+		bool r = SaveRemote(frame, isFixCode);
+		PopHeadFrame();
 		return r;
 	}
 	return false;
@@ -277,30 +1735,32 @@ bool ASKRmt_PickDataAndSaveRemote(bool isFixCode)
 
 bool ASKRmt_SaveRemoteAutoDetectType(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved) return false;
-		if (0b0001 == (ReceivedData[2] & 0xF)) return SaveRemote(false);
-		if (0b0011 == (ReceivedData[2] & 0xF)) return SaveRemote(true);
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved) return false;
+		if (0b0001 == (FrameCode(frame)[2] & 0xF)) return SaveRemote(frame, false);
+		if (0b0011 == (FrameCode(frame)[2] & 0xF)) return SaveRemote(frame, true);
 	}
 	return false;
 }
 
 bool ASKRmt_PickDataAndSaveRemoteAutoDetectType(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved)
 		{
-			DataReceived = false;
+			PopHeadFrame();
 			return false;
 		}
 		bool r = false;
-		if (0b0001 == (ReceivedData[2] & 0xF)) r = SaveRemote(false);
-		if (0b0011 == (ReceivedData[2] & 0xF)) r = SaveRemote(true);
-		DataReceived = false;
+		if (0b0001 == (FrameCode(frame)[2] & 0xF)) r = SaveRemote(frame, false);
+		if (0b0011 == (FrameCode(frame)[2] & 0xF)) r = SaveRemote(frame, true);
+		PopHeadFrame();
 		return r;
 	}
 	return false;
@@ -308,12 +1768,13 @@ bool ASKRmt_PickDataAndSaveRemoteAutoDetectType(void)
 
 bool ASKRmt_DeleteRemote(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved)
 		{
-			eeprom_write_byte((uint8_t *)(RemoteCodeAddr + 2), 0xFF);
+			EraseSlot(frame->Slot);
 			return true;
 		}
 	}
@@ -322,84 +1783,60 @@ bool ASKRmt_DeleteRemote(void)
 
 bool ASKRmt_PickDataAndDeleteRemote(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsRemoteSaved) IsRemoteSaved = CheckIsRemoteSaved();
-		if (IsRemoteSaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsRemoteSaved(frame);
+		if (frame->IsSaved)
 		{
-			eeprom_write_byte((uint8_t *)(RemoteCodeAddr + 2), 0xFF);
-			DataReceived = false;
+			EraseSlot(frame->Slot);
+			PopHeadFrame();
 			return true;
 		}
-		DataReceived = false;
+		PopHeadFrame();
 	}
 	return false;
 }
 
 bool ASKRmt_DeleteRemoteByCode(uint8_t *code)
 {
-	uint8_t val01, val2;
-	for (uint16_t addr = ASKRmt_EEPROM_START; addr < ASKRmt_EEPROM_END; addr += 3)
-	{
-		val2 = eeprom_read_byte((const uint8_t *)(addr + 2));
-		if (0xFF == val2) continue;
-		val01 = eeprom_read_byte((const uint8_t *)addr);
-		if (val01 != code[0]) continue;
-		val01 = eeprom_read_byte((const uint8_t *)(addr + 1));
-		if (val01 != code[1]) continue;
-		if ((val2 & 1) || (val2 == (code[2] & 0xF0))) 
-			eeprom_write_byte((uint8_t *)(addr + 2), 0xFF);
-		return true;
-	}
-	return false;
+	uint8_t saved[3];
+	SlotNumber slot = FindSlot(code, saved);
+	if (NO_SLOT == slot) return false;
+	EraseSlot(slot);
+	return true;
 }
 
 void ASKRmt_DeleteAllRemotes(void)
 {
-	for (uint16_t addr = ASKRmt_EEPROM_START; addr < ASKRmt_EEPROM_END; addr += 3)
-		if (0xFF != eeprom_read_byte((const uint8_t *)(addr + 2)))
-			eeprom_write_byte((uint8_t *)(addr + 2), 0xFF);
+	EraseAllSlots();
 }
 
-bool ASKRmt_GetRemoteCodeByIndex(uint8_t index, uint8_t *code)
+bool ASKRmt_GetRemoteCodeByIndex(uint16_t index, uint8_t *code)
 {
-	uint16_t addr = ASKRmt_EEPROM_START;
-	addr += index * 3;
-	if (addr + 2 > ASKRmt_EEPROM_END) return false;
-	code[0] = eeprom_read_byte((const uint8_t *)addr);
-	code[1] = eeprom_read_byte((const uint8_t *)(addr + 1));
-	code[2] = eeprom_read_byte((const uint8_t *)(addr + 2));
-	return true;
+	return ReadSlot(index, code);
 }
 
 #endif
 
 #ifdef ASKRmt_SAVEKEYCODESTOEEPROM
 
-bool CheckIsKeySaved(void)
+bool CheckIsKeySaved(ReceivedFrame *frame)
 {
-	uint8_t val;
-	for (KeyCodeAddr = ASKRmt_EEPROM_START; KeyCodeAddr < ASKRmt_EEPROM_END; KeyCodeAddr += 3)
-	{
-		val = eeprom_read_byte((const uint8_t *)(KeyCodeAddr + 2));
-		if (0xFF == val) continue;
-		if (val != ReceivedData[2]) continue;
-		val = eeprom_read_byte((const uint8_t *)KeyCodeAddr);
-		if (val != ReceivedData[0]) continue;
-		val = eeprom_read_byte((const uint8_t *)(KeyCodeAddr + 1));
-		if (val == ReceivedData[1]) return true;
-	}
-	return false;
+	uint8_t code[3];
+	frame->Slot = FindSlot(FrameCode(frame), code);
+	return (NO_SLOT != frame->Slot);
 }
 
 bool ASKRmt_GetKeyIfKeySaved(uint8_t *key)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsKeySaved) IsKeySaved = CheckIsKeySaved();
-		if (IsKeySaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+		if (frame->IsSaved)
 		{
-			*key = ReceivedData[2];
+			*key = FrameCode(frame)[2];
 			return true;
 		}
 	}
@@ -408,59 +1845,51 @@ bool ASKRmt_GetKeyIfKeySaved(uint8_t *key)
 
 bool ASKRmt_PickKeyIfKeySaved(uint8_t *key)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsKeySaved) IsKeySaved = CheckIsKeySaved();
-		if (IsKeySaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+		if (frame->IsSaved)
 		{
-			*key = ReceivedData[2];
-			DataReceived = false;
+			*key = FrameCode(frame)[2];
+			PopHeadFrame();
 			return true;
 		}
-		DataReceived = false;
+		PopHeadFrame();
 	}
 	return false;
 }
 
-bool SaveKey(void)
+bool SaveKey(ReceivedFrame *frame)
 {
-	uint8_t val;
-	for (KeyCodeAddr = ASKRmt_EEPROM_START; KeyCodeAddr < ASKRmt_EEPROM_END; KeyCodeAddr += 3)
-	{
-		val = eeprom_read_byte((const uint8_t *)(KeyCodeAddr + 2));
-		if (0xFF == val) {
-			eeprom_write_byte((uint8_t *)KeyCodeAddr, ReceivedData[0]);
-			eeprom_write_byte((uint8_t *)(KeyCodeAddr + 1), ReceivedData[1]);
-			eeprom_write_byte((uint8_t *)(KeyCodeAddr + 2), ReceivedData[2]);
-			return true;
-		}
-	}
-	return false;
+	return StoreCode(FrameCode(frame));
 }
 
 bool ASKRmt_SaveKey(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsKeySaved) IsKeySaved = CheckIsKeySaved();
-		if (IsKeySaved) return false;
-		return SaveKey();
+		if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+		if (frame->IsSaved) return false;
+		return SaveKey(frame);
 	}
 	return false;
 }
 
 bool ASKRmt_PickDataAndSaveKey(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsKeySaved) IsKeySaved = CheckIsKeySaved();
-		if (IsKeySaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+		if (frame->IsSaved)
 		{
-			DataReceived = false;
+			PopHeadFrame();
 			return false;
 		}
-		bool r = SaveKey();
-		DataReceived = false;
+		bool r = SaveKey(frame);
+		PopHeadFrame();
 		return r;
 	}
 	return false;
@@ -468,12 +1897,13 @@ bool ASKRmt_PickDataAndSaveKey(void)
 
 bool ASKRmt_DeleteKey(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsKeySaved) IsKeySaved = CheckIsKeySaved();
-		if (IsKeySaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+		if (frame->IsSaved)
 		{
-			eeprom_write_byte((uint8_t *)(KeyCodeAddr + 2), 0xFF);
+			EraseSlot(frame->Slot);
 			return true;
 		}
 	}
@@ -482,53 +1912,38 @@ bool ASKRmt_DeleteKey(void)
 
 bool ASKRmt_PickDataAndDeleteKey(void)
 {
-	if (DataReceived)
+	ReceivedFrame *frame = GetHeadFrame();
+	if (frame)
 	{
-		if (!IsKeySaved) IsKeySaved = CheckIsKeySaved();
-		if (IsKeySaved)
+		if (!frame->IsSaved) frame->IsSaved = CheckIsKeySaved(frame);
+		if (frame->IsSaved)
 		{
-			eeprom_write_byte((uint8_t *)(KeyCodeAddr + 2), 0xFF);
-			DataReceived = false;
+			EraseSlot(frame->Slot);
+			PopHeadFrame();
 			return true;
 		}
-		DataReceived = false;
+		PopHeadFrame();
 	}
 	return false;
 }
 
 bool ASKRmt_DeleteKeyByCode(uint8_t *code)
 {
-	uint8_t val;
-	for (uint16_t addr = ASKRmt_EEPROM_START; addr < ASKRmt_EEPROM_END; addr += 3)
-	{
-		val = eeprom_read_byte((const uint8_t *)(addr + 2));
-		if (0xFF == val) continue;
-		val = eeprom_read_byte((const uint8_t *)addr);
-		if (val != code[0]) continue;
-		val = eeprom_read_byte((const uint8_t *)(addr + 1));
-		if (val != code[1]) continue;
-		eeprom_write_byte((uint8_t *)(addr + 2), 0xFF);
-		return true;
-	}
-	return false;
+	uint8_t saved[3];
+	SlotNumber slot = FindSlot(code, saved);
+	if (NO_SLOT == slot) return false;
+	EraseSlot(slot);
+	return true;
 }
 
 void ASKRmt_DeleteAllKeys(void)
 {
-	for (uint16_t addr = ASKRmt_EEPROM_START; addr < ASKRmt_EEPROM_END; addr += 3)
-		if (0xFF != eeprom_read_byte((const uint8_t *)(addr + 2)))
-			eeprom_write_byte((uint8_t *)(addr + 2), 0xFF);
+	EraseAllSlots();
 }
 
-bool ASKRmt_GetKeyCodeByIndex(uint8_t index, uint8_t *code)
+bool ASKRmt_GetKeyCodeByIndex(uint16_t index, uint8_t *code)
 {
-	uint16_t addr = ASKRmt_EEPROM_START;
-	addr += index * 3;
-	if (addr + 2 > ASKRmt_EEPROM_END) return false;
-	code[0] = eeprom_read_byte((const uint8_t *)addr);
-	code[1] = eeprom_read_byte((const uint8_t *)(addr + 1));
-	code[2] = eeprom_read_byte((const uint8_t *)(addr + 2));
-	return true;
+	return ReadSlot(index, code);
 }
 
-#endif
\ No newline at end of file
+#endif
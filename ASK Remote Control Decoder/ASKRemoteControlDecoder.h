@@ -9,12 +9,15 @@
  *
  *   Created: 09 May 2019 01:57 AM
  *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
- * Last Edit: 08 Jun 2021
+ * Last Edit: 16 Oct 2026
  */ 
 
 #ifndef ASKRemoteControlDecoder_H_
 #define ASKRemoteControlDecoder_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
 /* You must define a 2-byte timer that runs at 1MHz. The default value of 
    TCCR1B register for running Timer1 at 1MHz with 1MHz internal RC oscillator 
    is 1 that starts Timer1 with no prescaling.                                 */
@@ -23,6 +26,30 @@
 #define ASKRmt_2BYTE1MHZTIMER_COUNTERVALUE TCNT1
 #define ASKRmt_2BYTE1MHZTIMER_RESETCOUNTER TCNT1 = 0
 
+/* Uncomment below definition to measure the signal with the input capture 
+   unit of Timer1 instead of a pin change interrupt. The RF signal must be 
+   connected to the ICP1 pin (PB0 on ATmega8A). Timer1 runs freely and the 
+   hardware latches the time of each change, so the interrupt latency does 
+   not affect the measured pulses and the counter is never reset. The 
+   timeout after 65536 microseconds of no signal uses the output compare A 
+   interrupt instead of the overflow interrupt. Call 
+   ASKRmt_InputCaptureInterrupt and ASKRmt_InputCaptureTimeoutInterrupt on 
+   the input capture and compare A interrupts instead of 
+   ASKRmt_RFSignalPinChanged and ASKRmt_TwoByte1MHzTimerOverflowInterrupt.     */
+//#define ASKRmt_INPUTCAPTURE
+
+/* You must define the input capture unit of a 2-byte timer that runs at 1MHz 
+   if ASKRmt_INPUTCAPTURE is defined. START runs Timer1 without prescaling 
+   and selects the edge that is opposite to the current pin value. Changing 
+   the edge may set the capture flag, so it is cleared after it.               */
+#define ASKRmt_INPUTCAPTURE_START          TCCR1A = 0, TCCR1B = (PINB & (1 << PINB0)) ? (1 << CS10) : ((1 << ICES1) | (1 << CS10)), TIFR = (1 << ICF1), TIMSK |= (1 << TICIE1)
+#define ASKRmt_INPUTCAPTURE_VALUE          ICR1
+#define ASKRmt_INPUTCAPTURE_ISRAISE        (TCCR1B & (1 << ICES1))
+#define ASKRmt_INPUTCAPTURE_TOGGLEEDGE     TCCR1B ^= (1 << ICES1), TIFR = (1 << ICF1)
+#define ASKRmt_INPUTCAPTURE_TIMEOUTSTART(t) OCR1A = (t), TIFR = (1 << OCF1A), TIMSK |= (1 << OCIE1A)
+#define ASKRmt_INPUTCAPTURE_TIMEOUTSTOP    TIMSK &= ~(1 << OCIE1A)
+#define ASKRmt_INPUTCAPTURE_TIMEOUTPENDING ((TIMSK & (1 << OCIE1A)) && (TIFR & (1 << OCF1A)))
+
 /* Comment below definition to reduce program size if you don't want to save 
    and detect remote controls automatically.                                   */
 #define ASKRmt_SAVEREMOTECONTROLSTOEEPROM
@@ -31,53 +58,401 @@
    and detect keys automatically.                                              */
 //#define ASKRmt_SAVEKEYCODESTOEEPROM
 
+/* Storage of the saved remote controls or keys. Uncomment one of below 
+   definitions. ASKRmt_STORAGE_EEPROM is the internal EEPROM. 
+   ASKRmt_STORAGE_FLASH is an area of the program flash that is written with 
+   SPM. ASKRmt_STORAGE_I2CEEPROM is an external 24Cxx EEPROM on the TWI pins. 
+   The flash and I2C storages are implemented in ASKRemoteControlStorage.cpp. 
+   The ASKRmt_EEPROM_* addresses are addresses of the selected storage. The 
+   host implementation always uses the emulated EEPROM or a file.              */
+#define ASKRmt_STORAGE_EEPROM
+//#define ASKRmt_STORAGE_FLASH
+//#define ASKRmt_STORAGE_I2CEEPROM
+
+#if defined(ASKRmt_STORAGE_EEPROM) + defined(ASKRmt_STORAGE_FLASH) + defined(ASKRmt_STORAGE_I2CEEPROM) != 1
+#error "Define exactly one of ASKRmt_STORAGE_EEPROM, ASKRmt_STORAGE_FLASH and ASKRmt_STORAGE_I2CEEPROM."
+#endif
+
+/* Size of the flash area of ASKRmt_STORAGE_FLASH in bytes. It must be a 
+   multiple of the flash page size (64 bytes on ATmega8A) and contain 
+   ASKRmt_EEPROM_END and ASKRmt_EEPROM_GENERATION. Writing a changed page 
+   erases and rewrites the whole page with the interrupts disabled (about 9 
+   milliseconds). SPM only works in the boot loader section, so the page 
+   write function is placed in the .bootloader section, which must be linked 
+   to the start of the boot section (-Wl,--section-start=.bootloader=0x1F00 
+   for the 256-byte boot section of ATmega8A, BOOTSZ fuses 11) and the boot 
+   lock bits must allow SPM. Programming the program flash erases the area.    */
+#define ASKRmt_FLASHSTORE_SIZE 64
+
+/* You must define the external EEPROM if ASKRmt_STORAGE_I2CEEPROM is 
+   defined. ADDRESS is the 7-bit device address (0x50 when A0-A2 are low) and 
+   PAGESIZE is the page write size (8 bytes for 24C01/02, 16 for 24C04/08/16, 
+   32 for 24C32/64 and 64 for 24C128/256). Uncomment 2BYTEADDRESS for 24C32 
+   and bigger devices. TWBR sets the SCL frequency to 
+   F_CPU / (16 + 2 * TWBR), which must be at most 100kHz for 24C01-16.         */
+#define ASKRmt_I2CEEPROM_ADDRESS  0x50
+#define ASKRmt_I2CEEPROM_PAGESIZE 8
+//#define ASKRmt_I2CEEPROM_2BYTEADDRESS
+#define ASKRmt_I2CEEPROM_TWBR     10
+
 /* You must define EEPROM start address and end address for saving remote 
    controls or keys codes. Each remote control code or key code occupies 3 
    bytes in the EEPROM.                                                        */
 #define ASKRmt_EEPROM_START 0
 #define ASKRmt_EEPROM_END  59
 
+/* EEPROM address of the generation byte of the saved remote controls. Each 
+   saved remote control is tagged with the generation that it was saved in 
+   (bits 1-3 of the 3rd byte, which are always 0 in the code) and deleting all 
+   of the remote controls only writes the next generation, so the codes of 
+   the other generations become free with one EEPROM write. It must be outside 
+   ASKRmt_EEPROM_START..ASKRmt_EEPROM_END and must not be used by the rest of 
+   the program. An erased byte is generation 0, so the remote controls that 
+   were saved before this byte was added stay saved. Keys use all bits of the 
+   3 bytes, so deleting all of the keys still erases each key.                 */
+#define ASKRmt_EEPROM_GENERATION (ASKRmt_EEPROM_END + 1)
+
+/* Uncomment below definition to save the remote controls or keys to a 
+   wear-levelled journal instead of fixed slots. ASKRmt_EEPROM_START.. 
+   ASKRmt_EEPROM_END is split into 2 banks and each save or delete appends a 
+   5-byte record with a CRC to the active bank, so the writes move through the 
+   EEPROM instead of rewriting the same bytes. When the bank is full, the saved 
+   codes are copied to the other bank. A record that is not completely written 
+   because of a power loss is ignored at startup. Each slot needs 20 bytes of 
+   EEPROM (0 to 403 for 20 slots) and the index must fit in 
+   ASKRmt_INDEX_RAM_BUDGET. Deleting all of the codes writes an empty bank, so 
+   ASKRmt_EEPROM_GENERATION is not used. The saved codes are not converted 
+   when this definition is changed.                                            */
+//#define ASKRmt_JOURNALEDSTORE
+
+/* Uncomment below definition to save thousands of remote controls or keys in 
+   a sorted store instead of fixed slots, for example in a 24C512 I2C EEPROM. 
+   ASKRmt_EEPROM_START..ASKRmt_EEPROM_END holds a directory and leaves of 
+   codes in the order of the codes (see ASKRemoteControlDatabase.h), so a 
+   lookup is a binary search of the directory and a read of one leaf instead 
+   of a scan of all of the slots. Saving or deleting a code rewrites the end of 
+   its leaf, and splitting a full leaf or removing an empty leaf also moves 
+   the end of the directory. The codes of the changed leaf may be lost if the 
+   power is lost during a save or delete. Each leaf needs 
+   6 + 3 * ASKRmt_SORTEDSTORE_LEAFRECORDS bytes and the store needs 2 more 
+   bytes. Deleting all of the codes writes 2 bytes. The slot of a code changes 
+   when the codes are saved or deleted. ASKRmt_DEFERREDVALIDATION must be 
+   defined. The index, ASKRmt_EEPROM_GENERATION and the journal are not used 
+   and the saved codes are not converted when this definition is changed.      */
+//#define ASKRmt_SORTEDSTORE
+
+/* Maximum number of codes of a leaf of the sorted store (2 to 84). Larger 
+   leaves make the directory smaller but each lookup reads a longer leaf and 
+   saving a code needs 3 bytes of stack per code. 21 codes make 64-byte 
+   leaves.                                                                     */
+#define ASKRmt_SORTEDSTORE_LEAFRECORDS 21
+
+/* Uncomment below definition to save PT2262 FixCode remote controls in 
+   2-byte slots instead of 3-byte slots. The 8 address trits of a remote 
+   control are packed in base 3 into 13 bits and the generation is kept in 
+   the other 3 bits, so 1.5 times as many remote controls fit between 
+   ASKRmt_EEPROM_START and ASKRmt_EEPROM_END (30 for the default addresses). 
+   LearningCode remote controls and addresses with a pair of bits 10 can not 
+   be saved. ASKRmt_SAVEREMOTECONTROLSTOEEPROM must be defined and the 
+   journaled and sorted stores are not used. The saved codes are not 
+   converted when this definition is changed.                                  */
+//#define ASKRmt_TRITPACKEDSTORE
+
+/* Maximum SRAM in bytes for the index of the saved remote controls or keys. 
+   The index keeps a copy of the EEPROM slots, a hash table and a bitmap of the 
+   free slots, so lookups do not read the EEPROM and the EEPROM is only 
+   written. It needs 3 bytes per slot, 16 to 256 bytes for the hash table (a 
+   power of 2 at least 1.5 times the number of slots) and 1 bit per slot. 
+   20 slots need 95 bytes. If the index does not fit in the budget, the EEPROM 
+   is scanned on each lookup. Assign 0 to always scan the EEPROM.              */
+#define ASKRmt_INDEX_RAM_BUDGET 128
+
+/* Number of entries of the EEPROM write queue. It must be 0 or a power of 2. 
+   Save and delete functions put their EEPROM byte writes into the queue and 
+   return immediately, and the EEPROM ready interrupt writes them in the 
+   background (about 8.5 milliseconds per byte). Lookups see the queued 
+   writes. If the queue is full, the functions wait for a free entry. Each 
+   entry occupies 3 bytes of SRAM. Call ASKRmt_EEPROMReadyInterrupt on the 
+   EEPROM ready interrupt. Assign 0 to write the EEPROM synchronously. The 
+   flash and I2C storages have no ready interrupt and are always written 
+   synchronously.                                                              */
+#define ASKRmt_EEPROMWRITEQUEUE_SIZE 8
+
+#if (ASKRmt_EEPROMWRITEQUEUE_SIZE > 128) || (ASKRmt_EEPROMWRITEQUEUE_SIZE & (ASKRmt_EEPROMWRITEQUEUE_SIZE - 1))
+#error "ASKRmt_EEPROMWRITEQUEUE_SIZE must be 0 or a power of 2 up to 128."
+#endif
+
+/* Number of slots of the receive queue. It must be a power of 2. The queue 
+   holds up to ASKRmt_RECEIVEQUEUE_SIZE - 1 received frames that are not picked 
+   or discarded yet. Each slot occupies up to 15 bytes of SRAM (ASKRmt_DATA_SIZE 
+   + 3 more for frames of more than 24 bits).                                  */
+#define ASKRmt_RECEIVEQUEUE_SIZE 4
+
+#if (ASKRmt_RECEIVEQUEUE_SIZE < 2) || (ASKRmt_RECEIVEQUEUE_SIZE & (ASKRmt_RECEIVEQUEUE_SIZE - 1))
+#error "ASKRmt_RECEIVEQUEUE_SIZE must be a power of 2."
+#endif
+
+/* Comment below definition to look up the received codes in the EEPROM 
+   inside the RF signal pin interrupt. By default the interrupt only marks a 
+   received frame as pending and the lookup is done by ASKRmt_Poll in the main 
+   program, so the interrupt length does not depend on the number of saved 
+   remote controls or keys. Unsaved frames occupy the receive queue until they 
+   are validated.                                                              */
+#define ASKRmt_DEFERREDVALIDATION
+
+/* Frames of the same code that are received at most ASKRmt_REPEAT_GAP 
+   milliseconds apart are one press of the key for the press handler of 
+   ASKRmt_SetPressHandler. The press is released after ASKRmt_REPEAT_GAP 
+   milliseconds without its code or when the signal is lost (no signal change 
+   for 65 milliseconds). A transmitter repeats the frame while the key is held 
+   and the decoder restarts after each frame, so a held key is received about 
+   every 100 milliseconds.                                                     */
+#define ASKRmt_REPEAT_GAP 250
+
+/* Comment below definition to queue every repeat of a held key. By default 
+   the RF signal interrupt drops a frame that repeats the code of the previous 
+   frame at most ASKRmt_REPEAT_GAP milliseconds after it and only counts it, so 
+   a press occupies one slot of the receive queue and the functions that read 
+   the received data find the first frame of each press. The counted repeats 
+   are delivered as HOLD events instead of FRAME events.                       */
+#define ASKRmt_COLLAPSEREPEATS
+
+/* Uncomment below definition to call the event handlers at the end of the RF 
+   signal interrupt instead of from ASKRmt_Dispatch. The received frames are 
+   not queued, so the functions that read the received data find no data. 
+   The handlers must be short and must not save or delete codes. 
+   ASKRmt_DEFERREDVALIDATION must be commented.                                */
+//#define ASKRmt_DISPATCHINISR
+
+/* Uncomment below definition to combine the repeats of a frame at long range. 
+   A bit with an out of range pulse ratio does not invalidate the packet, and 
+   a packet with up to 3 such bits is received if the bitwise majority of the 
+   last 4 packets decides them (see ASKRemoteControlCore.h). It uses 35 bytes 
+   of RAM (8 * ASKRmt_DATA_SIZE + 11) and the RF signal interrupt is longer at 
+   the end of such packets.                                                    */
+//#define ASKRmt_SOFTCOMBINING
+
+/* Comment below definition to check the bits of a frame with the ratio of
+   their pulses only. By default the preamble sets the length of a short pulse
+   of the frame and the bits are checked with the bounds that are computed
+   from it (see ASKRemoteControlCore.h). The pulse lengths of each remote
+   control are followed, and noise with the ratio of a bit but other pulse
+   lengths is rejected.                                                        */
+#define ASKRmt_ADAPTIVETIMING
+
+/* Protocols of the remote controls that are decoded. Uncomment the 
+   definitions of the protocols of your remote controls, at least one. Each 
+   protocol is decoded by its own state machine from the same signal, so each 
+   one makes the RF signal interrupt longer and uses 10 bytes of RAM (18 with 
+   ASKRmt_ADAPTIVETIMING, 4 more with ASKRmt_MAXFRAMEBITS above 32 and the 
+   RAM of ASKRmt_SOFTCOMBINING). The protocols are described in 
+   ASKRemoteControlCore.h. A frame is received into the last bits of the 
+   data. The saved codes do not keep the protocol. HT6P20B needs 
+   ASKRmt_MAXFRAMEBITS of 28 and EV1527LONG of 32. EV1527LONG ends a frame of 
+   less than 32 bits with the sync of the next repeat, so define only one of 
+   EV1527 and EV1527LONG. 
+   EV1527:      EV1527 LearningCode and PT2262 FixCode, 1:31 sync, 1:3 bits 
+   PRINCETON10: PT2262 compatible, 1:10 sync, 1:2 bits 
+   PRINCETON6:  PT2262 compatible, 1:6 sync, 1:3 bits 
+   HS2303:      HS2303-PT, 2:62 sync, 1:6 bits 
+   HT12E:       HT12E, 12 bits, 36:1 pilot and sync, 1:2 bits 
+   HT6P20B:     HT6P20B, 28 bits, 23:1 pilot and sync, 1:2 bits 
+   EV1527LONG:  EV1527 compatible, 24 to 32 bits, 1:31 sync, 1:3 bits          */
+#define ASKRmt_PROTOCOL_EV1527
+//#define ASKRmt_PROTOCOL_PRINCETON10
+//#define ASKRmt_PROTOCOL_PRINCETON6
+//#define ASKRmt_PROTOCOL_HS2303
+//#define ASKRmt_PROTOCOL_HT12E
+//#define ASKRmt_PROTOCOL_HT6P20B
+//#define ASKRmt_PROTOCOL_EV1527LONG
+
+#if !defined(ASKRmt_PROTOCOL_EV1527) && !defined(ASKRmt_PROTOCOL_PRINCETON10) && !defined(ASKRmt_PROTOCOL_PRINCETON6) && !defined(ASKRmt_PROTOCOL_HS2303) && !defined(ASKRmt_PROTOCOL_HT12E) && !defined(ASKRmt_PROTOCOL_HT6P20B) && !defined(ASKRmt_PROTOCOL_EV1527LONG)
+#error "Define at least one of the ASKRmt_PROTOCOL_* protocols."
+#endif
+
+#if defined(ASKRmt_PROTOCOL_EV1527) && defined(ASKRmt_PROTOCOL_EV1527LONG)
+#error "Define only one of ASKRmt_PROTOCOL_EV1527 and ASKRmt_PROTOCOL_EV1527LONG."
+#endif
+
+/* Maximum number of bits of a received frame, 24 to 64. The data arrays of 
+   ASKRmt_GetData, ASKRmt_PickData and the events have ASKRmt_DATA_SIZE bytes 
+   and a frame is in their last bits. The bits are received into a 32-bit 
+   shift register, or a 64-bit one above 32 bits, which makes each bit longer 
+   in the interrupt. The saved codes keep 3 bytes: the bytes before the last 3 
+   bytes of a longer frame are folded into the first 2 bytes of its code, and 
+   the key bits of its protocol are moved into the low nibble of the last 
+   byte.                                                                       */
+#define ASKRmt_MAXFRAMEBITS 24
+
+/* Bytes of the received data.                                                 */
+#define ASKRmt_DATA_SIZE ((ASKRmt_MAXFRAMEBITS + 7) / 8)
+
 /* Only one of save remotes or save keys modes are allowed.                    */
 #if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) && defined(ASKRmt_SAVEKEYCODESTOEEPROM)
 #error "Only one of save remotes or save keys modes are allowed."
 #endif
 
+/* Call this subroutine once at startup before enabling the interrupts. It 
+   reads the generation and builds the index of the saved remote controls or 
+   keys. Otherwise they are read by the first lookup. If ASKRmt_INPUTCAPTURE 
+   is defined, it starts Timer1 and the input capture interrupt, so this call 
+   is required.                                                                */
+void ASKRmt_Init(void);
+
+/* Received frames are stored in a queue. The functions below that read the 
+   data always work on the oldest frame of the queue and the functions that 
+   pick or discard the data remove it from the queue.                          */
+
+#ifndef ASKRmt_INPUTCAPTURE
 /* Call this subroutine on any change of RF signal pin value.                  */
 void ASKRmt_RFSignalPinChanged(uint8_t pinValue);
 
 /* Call this subroutine on 2-byte 1MHz timer overflow interrupt.               */
 void ASKRmt_TwoByte1MHzTimerOverflowInterrupt(void);
+#else
+/* Call this subroutine on the input capture interrupt (TIMER1_CAPT).          */
+void ASKRmt_InputCaptureInterrupt(void);
+
+/* Call this subroutine on the output compare A interrupt (TIMER1_COMPA).      */
+void ASKRmt_InputCaptureTimeoutInterrupt(void);
+#endif
+
+/* Number of received frames that have been dropped because the receive queue 
+   was full. It stops counting at 255. Assign 0 to reset it.                   */
+extern volatile uint8_t ASKRmt_ReceiveQueueOverflows;
+
+#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+/* Call this subroutine on the EEPROM ready interrupt (EE_RDY). It writes the 
+   next byte of the EEPROM write queue and disables the interrupt when the 
+   queue is empty.                                                             */
+void ASKRmt_EEPROMReadyInterrupt(void);
+
+/* Waits until all of the queued EEPROM writes are finished. Call it before 
+   turning off the power or entering a sleep mode that stops the EEPROM ready 
+   interrupt. It also works while the interrupts are disabled.                 */
+void ASKRmt_FlushEEPROMWrites(void);
+
+/* Returns true while EEPROM writes are queued or in progress.                 */
+bool ASKRmt_IsEEPROMBusy(void);
+
+/* Returns the number of queued EEPROM byte writes that are not started yet.   */
+uint8_t ASKRmt_PendingEEPROMWrites(void);
+
+/* Returns the number of indexes of ASKRmt_GetRemoteCodeByIndex and 
+   ASKRmt_GetKeyCodeByIndex.                                                   */
+uint16_t ASKRmt_GetSlotCount(void);
+
+/* Replaces the saved remote controls or keys with a list of codes. Call 
+   ASKRmt_BeginImport, ASKRmt_ImportCode for each code and ASKRmt_EndImport, 
+   which deletes the saved codes that are not imported. The fixed slots and 
+   the journal save the n-th imported code to the n-th slot and the sorted 
+   store needs the codes in ascending order, so only the changed codes are 
+   written and importing the saved codes again writes nothing. 
+   ASKRmt_ImportCode returns false if the store is full, the 3rd byte of the 
+   code is 0xFF or the code is not greater than the previous code in the 
+   sorted store.                                                               */
+void ASKRmt_BeginImport(void);
+bool ASKRmt_ImportCode(const uint8_t *code);
+void ASKRmt_EndImport(void);
+
+/* Call this subroutine for each byte that is received from the UART to 
+   export and import the saved remote controls or keys with the protocol of 
+   ASKRemoteControlTransfer.h. The responses are sent with "send". Add 
+   ASKRemoteControlTransfer.cpp to the project to use it.                      */
+void ASKRmt_TransferReceivedByte(uint8_t byte, void (*send)(uint8_t byte));
+#endif
+
+/* Looks up the pending received frames in the EEPROM and discards the unsaved 
+   ones if ASKRmt_AutoDiscardUnsavedRemotes or ASKRmt_AutoDiscardUnsavedKeys is 
+   true. Call this subroutine in the main loop. The functions below call it 
+   too, so only validated data is returned. It does nothing if 
+   ASKRmt_DEFERREDVALIDATION is not defined.                                   */
+void ASKRmt_Poll(void);
 
 /* Returns true if valid data is received.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_IsDataReceived(void);
 
-/* Discards the received data.
-   Note that while data is not picked or discarded, new data will not receive. */
+/* Discards the received data.                                                 */
 void ASKRmt_DiscardData(void);
 
 /* Reads the data and returns true if valid data is received. The received data 
-   (3 bytes) will be copied to the "data" array.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   (ASKRmt_DATA_SIZE bytes) will be copied to the "data" array.
+   This function will not pick the data.                                       */
 bool ASKRmt_GetData(uint8_t *data);
 
 /* Picks the data and returns true if valid data is received. The received data 
-   (3 bytes) will be copied to the "data" array.
-   Note that while data is not picked or discarded, new data will not receive. */
+   (ASKRmt_DATA_SIZE bytes) will be copied to the "data" array.                */
 bool ASKRmt_PickData(uint8_t *data);
 
 /* Returns the key number if valid data is received, otherwise returns -1.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 int8_t ASKRmt_GetKey(bool isFixCode);
 
 /* Picks the data and returns the key number if valid data is received, 
-   otherwise returns -1.
-   Note that while data is not picked or discarded, new data will not receive. */
+   otherwise returns -1.                                                       */
 int8_t ASKRmt_PickKey(bool isFixCode);
 
+/* Returns the ASKRmt_PROTOCOLID_* value of the protocol of the received data 
+   if valid data is received, otherwise returns -1.
+   This function will not pick the data.                                       */
+int8_t ASKRmt_GetProtocol(void);
+
+/* Returns the number of bits of the received data if valid data is received, 
+   otherwise returns -1.
+   This function will not pick the data.                                       */
+int8_t ASKRmt_GetDataBits(void);
+
+/* Returns the address of a PT2262 FixCode remote control, its 8 address 
+   trits packed in base 3 (0 to 6560), if valid data of 12 trits is received, 
+   otherwise returns -1.
+   This function will not pick the data.                                       */
+int16_t ASKRmt_GetTriStateAddress(void);
+
+/* Types of the received events. A FRAME event is delivered for each received 
+   frame, a PRESS event for the first frame of a press of a key, HOLD events 
+   while the key is held and a RELEASE event when the press ends.              */
+#define ASKRmt_EVENT_FRAME   0
+#define ASKRmt_EVENT_PRESS   1
+#define ASKRmt_EVENT_RELEASE 2
+#define ASKRmt_EVENT_HOLD    3
+
+typedef struct
+{
+	uint8_t  Type;                   // ASKRmt_EVENT_*
+	uint8_t  Data[ASKRmt_DATA_SIZE]; // received code, in the last bits
+	uint8_t  Bits;                   // number of bits of the code
+	uint8_t  Protocol;               // ASKRmt_PROTOCOLID_* value of the protocol of the code
+	bool     IsSaved;                // the remote control/key code is saved
+	uint8_t  Key;                    // key number of a saved remote control or 3rd byte of a saved key, otherwise 0
+	uint16_t Duration;               // milliseconds from the press to the last frame of the press, for HOLD and RELEASE events
+} ASKRmt_Event;
+
+typedef void (*ASKRmt_EventHandler)(const ASKRmt_Event *event);
+
+/* Register the handler of the received frames and the handler of the presses 
+   and releases of the keys. Assign 0 to remove a handler. The received code 
+   is looked up in the EEPROM before the handlers are called, so the events 
+   tell if it is saved and its key number. If ASKRmt_AutoDiscardUnsavedRemotes 
+   or ASKRmt_AutoDiscardUnsavedKeys is true, only saved codes are delivered.   */
+void ASKRmt_SetFrameHandler(ASKRmt_EventHandler handler);
+void ASKRmt_SetPressHandler(ASKRmt_EventHandler handler);
+
+/* Delivers the received frames to the handlers, picks them and delivers the 
+   release of a press that has ended. Call this subroutine in the main loop 
+   instead of ASKRmt_Poll and the functions that read the received data. While 
+   the handlers of a frame run, it is the oldest received frame, so they can 
+   call the functions that work on the received data, for example 
+   ASKRmt_SaveRemoteAutoDetectType. It does nothing if ASKRmt_DISPATCHINISR is 
+   defined.                                                                    */
+void ASKRmt_Dispatch(void);
+
+/* Returns true if no received frame is waiting for ASKRmt_Dispatch or the 
+   functions that read the received data. It does not look up the frames and 
+   it can be called while the interrupts are disabled, for example before 
+   entering a sleep mode.                                                      */
+bool ASKRmt_IsReceiveQueueEmpty(void);
+
 #ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
 
 /* If this variable is true and the received data remote control code is not 
@@ -88,14 +463,12 @@ extern volatile bool ASKRmt_AutoDiscardUnsavedRemotes;
 /* Returns the key number if valid data is received and remote control code has 
    been saved to the EEPROM, otherwise returns -1. The type of remote control 
    will be detected automatically.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 int8_t ASKRmt_GetKeyIfRemoteSaved(void);
 
 /* Picks the data and returns the key number if valid data is received and 
    remote control code has been saved to the EEPROM, otherwise returns -1. The 
-   type of remote control will be detected automatically.
-   Note that while data is not picked or discarded, new data will not receive. */
+   type of remote control will be detected automatically.                      */
 int8_t ASKRmt_PickKeyIfRemoteSaved(void);
 
 /* Saves the remote control code to the EEPROM if valid data is received. This 
@@ -103,16 +476,14 @@ int8_t ASKRmt_PickKeyIfRemoteSaved(void);
    saved or the EEPROM is full.
    You must assign false to ASKRmt_AutoDiscardUnsavedRemotes before the saving 
    process. 
-   This function will not pick the data. 
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_SaveRemote(bool isFixCode);
 
 /* Picks the data and saves the remote control code to the EEPROM if valid data 
    is received. This function returns false if no valid data is received or the 
    code is already saved or the EEPROM is full.
    You must assign false to ASKRmt_AutoDiscardUnsavedRemotes before the saving 
-   process.
-   Note that while data is not picked or discarded, new data will not receive. */
+   process.                                                                    */
 bool ASKRmt_PickDataAndSaveRemote(bool isFixCode);
 
 /* Saves the remote control code to the EEPROM if valid data is received. The 
@@ -122,8 +493,7 @@ bool ASKRmt_PickDataAndSaveRemote(bool isFixCode);
    due to pressing another key.
    You must assign false to ASKRmt_AutoDiscardUnsavedRemotes before the saving 
    process.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_SaveRemoteAutoDetectType(void);
 
 /* Picks the data and saves the remote control code to the EEPROM if valid data 
@@ -132,23 +502,20 @@ bool ASKRmt_SaveRemoteAutoDetectType(void);
    data is received or the code is already saved or the EEPROM is full or type 
    detection fails due to pressing another key.
    You must assign false to ASKRmt_AutoDiscardUnsavedRemotes before the saving 
-   process.
-   Note that while data is not picked or discarded, new data will not receive. */
+   process.                                                                    */
 bool ASKRmt_PickDataAndSaveRemoteAutoDetectType(void);
 
 /* Deletes the remote control code from the EEPROM if valid data is received. 
    The type of remote control will be detected automatically. This function 
    returns false if no valid data is received or the code does not exist in the 
    EEPROM.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_DeleteRemote(void);
 
 /* Picks the data and deletes the remote control code from the EEPROM if valid 
    data is received. The type of remote control will be detected automatically. 
    This function returns false if no valid data is received or the code does 
-   not exist in the EEPROM.
-   Note that while data is not picked or discarded, new data will not receive. */
+   not exist in the EEPROM.                                                    */
 bool ASKRmt_PickDataAndDeleteRemote(void);
 
 /* Deletes the remote control code from the EEPROM. The type of remote control 
@@ -156,13 +523,14 @@ bool ASKRmt_PickDataAndDeleteRemote(void);
    bytes. This function returns false if the code does not exist in the EEPROM.*/
 bool ASKRmt_DeleteRemoteByCode(uint8_t *code);
 
-/* Deletes all of the saved remote controls from the EEPROM.                   */
+/* Deletes all of the saved remote controls from the EEPROM. It writes one 
+   byte, the next generation, to the EEPROM.                                   */
 void ASKRmt_DeleteAllRemotes(void);
 
 /* This function reads a remote control code from the EEPROM by index and 
    copies 3 bytes of code to the "code" array. This function returns false if 
-   the index is out of range.                                                  */
-bool ASKRmt_GetRemoteCodeByIndex(uint8_t index, uint8_t *code);
+   the index is out of range. The sorted store has more than 255 indexes.      */
+bool ASKRmt_GetRemoteCodeByIndex(uint16_t index, uint8_t *code);
 
 #endif
 
@@ -176,15 +544,13 @@ extern volatile bool ASKRmt_AutoDiscardUnsavedKeys;
    EEPROM, otherwise returns false. The key number will be stored to the 
    variable pointed by the "key" parameter. The type of remote control will not 
    be detected automatically.
-   This function will not pick the data. 
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_GetKeyIfKeySaved(uint8_t *key);
 
 /* Picks the data and returns true if valid data is received and key code has 
    been saved to the EEPROM, otherwise returns false. The key number will be 
    stored to the variable pointed by the "key" parameter. The type of remote 
-   control will not be detected automatically.
-   Note that while data is not picked or discarded, new data will not receive. */
+   control will not be detected automatically.                                 */
 bool ASKRmt_PickKeyIfKeySaved(uint8_t *key);
 
 /* Saves the key code to the EEPROM if valid data is received. This function 
@@ -192,29 +558,25 @@ bool ASKRmt_PickKeyIfKeySaved(uint8_t *key);
    the EEPROM is full.
    You must assign false to ASKRmt_AutoDiscardUnsavedKeys before the saving 
    process.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_SaveKey(void);
 
 /* Picks the data and saves the key code to the EEPROM if valid data is 
    received. This function returns false if no valid data is received or the 
    code is already saved or the EEPROM is full.
    You must assign false to ASKRmt_AutoDiscardUnsavedKeys before the saving 
-   process.
-   Note that while data is not picked or discarded, new data will not receive. */
+   process.                                                                    */
 bool ASKRmt_PickDataAndSaveKey(void);
 
 /* Deletes the key code from the EEPROM if valid data is received. This 
    function returns false if no valid data is received or the code does not 
    exist in the EEPROM.
-   This function will not pick the data.
-   Note that while data is not picked or discarded, new data will not receive. */
+   This function will not pick the data.                                       */
 bool ASKRmt_DeleteKey(void);
 
 /* Picks the data and deletes the key code from the EEPROM if valid data is 
    received. This function returns false if no valid data is received or the 
-   code does not exist in the EEPROM.
-   Note that while data is not picked or discarded, new data will not receive. */
+   code does not exist in the EEPROM.                                          */
 bool ASKRmt_PickDataAndDeleteKey(void);
 
 /* Deletes the key code from the EEPROM. "code" is the pointer to an array of 3 
@@ -226,8 +588,8 @@ void ASKRmt_DeleteAllKeys(void);
 
 /* This function reads a key code from the EEPROM by index and copies 3 bytes 
    of code to the "code" array. This function returns false if the index is out 
-   of range. */
-bool ASKRmt_GetKeyCodeByIndex(uint8_t index, uint8_t *code);
+   of range. The sorted store has more than 255 indexes. */
+bool ASKRmt_GetKeyCodeByIndex(uint16_t index, uint8_t *code);
 
 #endif
 
@@ -0,0 +1,202 @@
+/*
+ * ASKRemoteControlHAL.h
+ *  Hardware abstraction layer of the ASK RF remote controls signal decoder. It binds the decoder to the AVR timer and
+ *  the selected storage, or to the host implementation in ASKRemoteControlHostHAL.cpp when it is not compiled for AVR.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRemoteControlHAL_H_
+#define ASKRemoteControlHAL_H_
+
+#if defined(__AVR__)
+
+#include <avr/io.h>
+#include <avr/cpufunc.h>
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+
+/* Timer bindings. They use the ASKRmt_2BYTE1MHZTIMER_* definitions of
+   ASKRemoteControlDecoder.h.                                                  */
+#define ASKRmt_HAL_TIMERSTART()      ASKRmt_2BYTE1MHZTIMER_START
+#define ASKRmt_HAL_TIMERSTOP()       ASKRmt_2BYTE1MHZTIMER_STOP
+#define ASKRmt_HAL_TIMERVALUE()      ASKRmt_2BYTE1MHZTIMER_COUNTERVALUE
+#define ASKRmt_HAL_TIMERRESET()      ASKRmt_2BYTE1MHZTIMER_RESETCOUNTER
+
+/* Input capture bindings. They use the ASKRmt_INPUTCAPTURE_* definitions of
+   ASKRemoteControlDecoder.h.                                                  */
+#define ASKRmt_HAL_CAPTURESTART()       ASKRmt_INPUTCAPTURE_START
+#define ASKRmt_HAL_CAPTUREVALUE()       ASKRmt_INPUTCAPTURE_VALUE
+#define ASKRmt_HAL_CAPTUREISRAISE()     ASKRmt_INPUTCAPTURE_ISRAISE
+#define ASKRmt_HAL_CAPTURETOGGLEEDGE()  ASKRmt_INPUTCAPTURE_TOGGLEEDGE
+#define ASKRmt_HAL_TIMEOUTSTART(t)      ASKRmt_INPUTCAPTURE_TIMEOUTSTART(t)
+#define ASKRmt_HAL_TIMEOUTSTOP()        ASKRmt_INPUTCAPTURE_TIMEOUTSTOP
+#define ASKRmt_HAL_TIMEOUTPENDING()     ASKRmt_INPUTCAPTURE_TIMEOUTPENDING
+
+/* Storage bindings. Addresses are addresses of the selected storage. 
+   STORAGEWRITE starts a byte write and STORAGEWRITEBLOCK only writes the 
+   bytes that are changed, in the order of their addresses. Both wait until 
+   the previous write is finished.                                             */
+#if defined(ASKRmt_STORAGE_FLASH)
+
+uint8_t ASKRmtFlash_Read(uint16_t addr);
+void    ASKRmtFlash_ReadBlock(void *dst, uint16_t addr, uint16_t n);
+void    ASKRmtFlash_UpdateBlock(const void *src, uint16_t addr, uint16_t n);
+
+#define ASKRmt_HAL_STORAGEREAD(addr)               ASKRmtFlash_Read(addr)
+#define ASKRmt_HAL_STORAGEWRITE(addr, val)         do { uint8_t v_ = (val); ASKRmtFlash_UpdateBlock(&v_, (addr), 1); } while (0)
+#define ASKRmt_HAL_STORAGEREADBLOCK(dst, addr, n)  ASKRmtFlash_ReadBlock((dst), (addr), (n))
+#define ASKRmt_HAL_STORAGEWRITEBLOCK(src, addr, n) ASKRmtFlash_UpdateBlock((src), (addr), (n))
+#define ASKRmt_HAL_STORAGEISREADY()                true // pages are written synchronously
+
+#elif defined(ASKRmt_STORAGE_I2CEEPROM)
+
+uint8_t ASKRmtI2C_Read(uint16_t addr);
+void    ASKRmtI2C_ReadBlock(void *dst, uint16_t addr, uint16_t n);
+void    ASKRmtI2C_UpdateBlock(const void *src, uint16_t addr, uint16_t n);
+bool    ASKRmtI2C_IsReady(void);
+
+#define ASKRmt_HAL_STORAGEREAD(addr)               ASKRmtI2C_Read(addr)
+#define ASKRmt_HAL_STORAGEWRITE(addr, val)         do { uint8_t v_ = (val); ASKRmtI2C_UpdateBlock(&v_, (addr), 1); } while (0)
+#define ASKRmt_HAL_STORAGEREADBLOCK(dst, addr, n)  ASKRmtI2C_ReadBlock((dst), (addr), (n))
+#define ASKRmt_HAL_STORAGEWRITEBLOCK(src, addr, n) ASKRmtI2C_UpdateBlock((src), (addr), (n))
+#define ASKRmt_HAL_STORAGEISREADY()                ASKRmtI2C_IsReady()
+
+#else
+
+#define ASKRmt_HAL_STORAGEREAD(addr)               eeprom_read_byte((const uint8_t *)(addr))
+#define ASKRmt_HAL_STORAGEWRITE(addr, val)         eeprom_write_byte((uint8_t *)(addr), (val))
+#define ASKRmt_HAL_STORAGEREADBLOCK(dst, addr, n)  eeprom_read_block((dst), (const void *)(addr), (n))
+#define ASKRmt_HAL_STORAGEWRITEBLOCK(src, addr, n) eeprom_update_block((src), (void *)(addr), (n))
+
+/* EEPROM ready bindings. The EEPROM is ready when no write is in progress and 
+   the ready interrupt is raised while it is ready and enabled. Only the 
+   internal EEPROM has a ready interrupt, so the write queue is only used with 
+   it.                                                                         */
+#define ASKRmt_HAL_STORAGEREADYINTERRUPT
+#define ASKRmt_HAL_STORAGEISREADY()            eeprom_is_ready()
+#define ASKRmt_HAL_STORAGEREADYINTERRUPTON()   EECR |= (1 << EERIE)
+#define ASKRmt_HAL_STORAGEREADYINTERRUPTOFF()  EECR &= ~(1 << EERIE)
+
+#endif
+
+/* Compiler and interrupt bindings.                                            */
+#define ASKRmt_HAL_MEMORYBARRIER()   _MemoryBarrier()
+#define ASKRmt_HAL_ATOMIC            ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+
+#else
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Size of the emulated EEPROM of the host implementation in bytes. It is the
+   size of a 24C512 I2C EEPROM if the store does not fit in 4096 bytes.        */
+#if ASKRmt_EEPROM_END < 4095
+#define ASKRmtHost_STORAGE_SIZE 4096
+#else
+#define ASKRmtHost_STORAGE_SIZE 65536L
+#endif
+
+/* One change of the RF signal pin: the time in microseconds and the new pin
+   value.                                                                      */
+typedef struct
+{
+	uint64_t Time;
+	uint8_t  Level;
+} ASKRmtHost_Edge;
+
+/* Emulated 1MHz timer.                                                        */
+void     ASKRmtHost_TimerStart(void);
+void     ASKRmtHost_TimerStop(void);
+uint16_t ASKRmtHost_TimerValue(void);
+void     ASKRmtHost_TimerReset(void);
+
+/* Emulated input capture unit of a free-running 1MHz timer. The capture edge
+   starts at raise and the timeout fires 65536 microseconds after the capture
+   time that it is started with.                                               */
+void     ASKRmtHost_CaptureStart(void);
+uint16_t ASKRmtHost_CaptureValue(void);
+bool     ASKRmtHost_CaptureIsRaise(void);
+void     ASKRmtHost_CaptureToggleEdge(void);
+void     ASKRmtHost_TimeoutStart(uint16_t capture);
+void     ASKRmtHost_TimeoutStop(void);
+
+/* Emulated EEPROM. It is erased (0xFF) at startup.                            */
+extern uint8_t ASKRmtHost_Storage[ASKRmtHost_STORAGE_SIZE];
+
+/* Emulated EEPROM ready interrupt. Writes of the emulated EEPROM finish 
+   immediately, so the EEPROM is always ready and the enabled interrupt is 
+   raised before each fed signal change until it is disabled.                  */
+void     ASKRmtHost_StorageReadyInterruptOn(void);
+void     ASKRmtHost_StorageReadyInterruptOff(void);
+
+/* Loads the emulated EEPROM from a file or saves it to a file. They return
+   false if the file can not be read or written. A missing or short file
+   leaves the rest of the EEPROM erased.                                       */
+bool ASKRmtHost_LoadStorage(const char *path);
+bool ASKRmtHost_SaveStorage(const char *path);
+
+/* File-backed storage. While a file is open, the storage is read from and
+   written to the file instead of ASKRmtHost_Storage, and each write is
+   written to the file immediately, so the file keeps the saved codes like an
+   EEPROM if the program is killed. Bytes after the end of the file read as
+   erased. The file is created if it is missing. Returns false if it can not
+   be opened.                                                                  */
+bool ASKRmtHost_OpenStorageFile(const char *path);
+void ASKRmtHost_CloseStorageFile(void);
+
+/* Storage of the host implementation: the open file or the emulated EEPROM.   */
+uint8_t ASKRmtHost_StorageRead(uint16_t addr);
+void    ASKRmtHost_StorageWrite(uint16_t addr, uint8_t val);
+void    ASKRmtHost_StorageReadBlock(void *dst, uint16_t addr, uint16_t n);
+void    ASKRmtHost_StorageUpdateBlock(const void *src, uint16_t addr, uint16_t n);
+
+/* Feeds a change of the RF signal pin at "time" microseconds to the decoder.
+   The timer overflow interrupt is raised before it if the timer runs for
+   more than 65535 microseconds. If ASKRmt_INPUTCAPTURE is defined, the
+   timeout and the input capture interrupts are raised instead and changes to
+   the pin value that is not selected by the capture edge are ignored. Times
+   must not decrease.                                                          */
+void ASKRmtHost_FeedEdge(uint64_t time, uint8_t level);
+
+/* Feeds "count" changes of the RF signal pin from a buffer.                   */
+void ASKRmtHost_FeedEdges(const ASKRmtHost_Edge *edges, size_t count);
+
+#define ASKRmt_HAL_TIMERSTART()      ASKRmtHost_TimerStart()
+#define ASKRmt_HAL_TIMERSTOP()       ASKRmtHost_TimerStop()
+#define ASKRmt_HAL_TIMERVALUE()      ASKRmtHost_TimerValue()
+#define ASKRmt_HAL_TIMERRESET()      ASKRmtHost_TimerReset()
+
+#define ASKRmt_HAL_CAPTURESTART()       ASKRmtHost_CaptureStart()
+#define ASKRmt_HAL_CAPTUREVALUE()       ASKRmtHost_CaptureValue()
+#define ASKRmt_HAL_CAPTUREISRAISE()     ASKRmtHost_CaptureIsRaise()
+#define ASKRmt_HAL_CAPTURETOGGLEEDGE()  ASKRmtHost_CaptureToggleEdge()
+#define ASKRmt_HAL_TIMEOUTSTART(t)      ASKRmtHost_TimeoutStart(t)
+#define ASKRmt_HAL_TIMEOUTSTOP()        ASKRmtHost_TimeoutStop()
+#define ASKRmt_HAL_TIMEOUTPENDING()     false // the host raises the timeout before the capture
+
+#define ASKRmt_HAL_STORAGEREAD(addr)               ASKRmtHost_StorageRead(addr)
+#define ASKRmt_HAL_STORAGEWRITE(addr, val)         ASKRmtHost_StorageWrite((addr), (val))
+#define ASKRmt_HAL_STORAGEREADBLOCK(dst, addr, n)  ASKRmtHost_StorageReadBlock((dst), (addr), (n))
+#define ASKRmt_HAL_STORAGEWRITEBLOCK(src, addr, n) ASKRmtHost_StorageUpdateBlock((src), (addr), (n))
+
+#define ASKRmt_HAL_STORAGEREADYINTERRUPT
+#define ASKRmt_HAL_STORAGEISREADY()            true
+#define ASKRmt_HAL_STORAGEREADYINTERRUPTON()   ASKRmtHost_StorageReadyInterruptOn()
+#define ASKRmt_HAL_STORAGEREADYINTERRUPTOFF()  ASKRmtHost_StorageReadyInterruptOff()
+
+/* The host implementation calls the interrupt subroutines synchronously.      */
+#define ASKRmt_HAL_MEMORYBARRIER()   __asm__ __volatile__("" ::: "memory")
+#define ASKRmt_HAL_ATOMIC
+
+#endif
+
+#endif /* ASKRemoteControlHAL_H_ */
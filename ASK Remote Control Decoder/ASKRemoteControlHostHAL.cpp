@@ -0,0 +1,243 @@
+/*
+ * ASKRemoteControlHostHAL.cpp
+ *  Host (Linux) implementation of the hardware abstraction layer of the ASK RF remote controls signal decoder. The
+ *  timer is emulated from the times of the fed signal changes and the EEPROM is a byte array that can be loaded from
+ *  and saved to a file, or a file that is read and written directly.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#if !defined(__AVR__)
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ASKRemoteControlDecoder.h"
+#include "ASKRemoteControlHAL.h"
+
+uint8_t  ASKRmtHost_Storage[ASKRmtHost_STORAGE_SIZE];
+
+uint64_t HostTime;               // time of the current signal change
+uint64_t HostTimerBase;          // time that the running timer counted from 0
+uint16_t HostTimerFrozen;        // counter value of the stopped timer
+bool     HostTimerRunning = false;
+bool     HostCaptureRaise = true;   // selected capture edge
+bool     HostTimeoutRunning = false;
+uint64_t HostTimeoutTime;           // time of the timeout interrupt
+bool     HostStorageReadyInterrupt = false;
+uint16_t HostStorageAddress;        // address register of the emulated EEPROM
+int      HostStorageFile = -1;      // file descriptor of the file-backed storage
+
+/* Erases the emulated EEPROM before main() like a new microcontroller.        */
+struct HostStorageEraser
+{
+	HostStorageEraser() { memset(ASKRmtHost_Storage, 0xFF, sizeof(ASKRmtHost_Storage)); }
+} HostStorageEraserInstance;
+
+void ASKRmtHost_TimerStart(void)
+{
+	if (HostTimerRunning) return;
+	HostTimerBase = HostTime - HostTimerFrozen;
+	HostTimerRunning = true;
+}
+
+void ASKRmtHost_TimerStop(void)
+{
+	if (!HostTimerRunning) return;
+	HostTimerFrozen = (uint16_t)(HostTime - HostTimerBase);
+	HostTimerRunning = false;
+}
+
+uint16_t ASKRmtHost_TimerValue(void)
+{
+	if (HostTimerRunning) return (uint16_t)(HostTime - HostTimerBase);
+	return HostTimerFrozen;
+}
+
+void ASKRmtHost_TimerReset(void)
+{
+	HostTimerBase = HostTime;
+	HostTimerFrozen = 0;
+}
+
+void ASKRmtHost_CaptureStart(void)
+{
+	HostCaptureRaise = true; // the pin is low at startup
+}
+
+uint16_t ASKRmtHost_CaptureValue(void)
+{
+	return (uint16_t)HostTime; // the free-running counter at the change
+}
+
+bool ASKRmtHost_CaptureIsRaise(void)
+{
+	return HostCaptureRaise;
+}
+
+void ASKRmtHost_CaptureToggleEdge(void)
+{
+	HostCaptureRaise = !HostCaptureRaise;
+}
+
+void ASKRmtHost_TimeoutStart(uint16_t capture)
+{
+	// the compare match occurs when the counter reaches the capture value again
+	HostTimeoutTime = HostTime - (uint16_t)((uint16_t)HostTime - capture) + 0x10000;
+	HostTimeoutRunning = true;
+}
+
+void ASKRmtHost_TimeoutStop(void)
+{
+	HostTimeoutRunning = false;
+}
+
+void ASKRmtHost_StorageReadyInterruptOn(void)
+{
+	HostStorageReadyInterrupt = true;
+}
+
+void ASKRmtHost_StorageReadyInterruptOff(void)
+{
+	HostStorageReadyInterrupt = false;
+}
+
+bool ASKRmtHost_LoadStorage(const char *path)
+{
+	FILE *f = fopen(path, "rb");
+	if (!f) return false;
+	size_t n = fread(ASKRmtHost_Storage, 1, sizeof(ASKRmtHost_Storage), f);
+	bool r = !ferror(f);
+	fclose(f);
+	memset(ASKRmtHost_Storage + n, 0xFF, sizeof(ASKRmtHost_Storage) - n);
+	return r;
+}
+
+bool ASKRmtHost_SaveStorage(const char *path)
+{
+	FILE *f = fopen(path, "wb");
+	if (!f) return false;
+	bool r = (fwrite(ASKRmtHost_Storage, 1, sizeof(ASKRmtHost_Storage), f) == sizeof(ASKRmtHost_Storage));
+	if (fclose(f)) r = false;
+	return r;
+}
+
+/* The file is extended with erased bytes to the size of the emulated EEPROM, 
+   so each address is in the file.                                             */
+bool ASKRmtHost_OpenStorageFile(const char *path)
+{
+	ASKRmtHost_CloseStorageFile();
+	int file = open(path, O_RDWR | O_CREAT, 0644);
+	if (file < 0) return false;
+	off_t size = lseek(file, 0, SEEK_END);
+	uint8_t erased[256];
+	memset(erased, 0xFF, sizeof(erased));
+	while ((size >= 0) && (size < ASKRmtHost_STORAGE_SIZE))
+	{
+		size_t n = ASKRmtHost_STORAGE_SIZE - size;
+		if (n > sizeof(erased)) n = sizeof(erased);
+		ssize_t w = pwrite(file, erased, n, size);
+		if (w <= 0) size = -1;
+		else size += w;
+	}
+	if (size < 0)
+	{
+		close(file);
+		return false;
+	}
+	HostStorageFile = file;
+	return true;
+}
+
+void ASKRmtHost_CloseStorageFile(void)
+{
+	if (HostStorageFile >= 0) close(HostStorageFile);
+	HostStorageFile = -1;
+}
+
+/* A byte read loads the address register and then reads the byte. The 
+   emulated EEPROM is always ready, so an enabled EEPROM ready interrupt is 
+   raised between them like it can be on an AVR, and a write that it starts 
+   loads its own address, so the read returns the byte of that address.        */
+uint8_t ASKRmtHost_StorageRead(uint16_t addr)
+{
+	HostStorageAddress = addr;
+	#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+	if (HostStorageReadyInterrupt) ASKRmt_EEPROMReadyInterrupt();
+	#endif
+	uint8_t val;
+	ASKRmtHost_StorageReadBlock(&val, HostStorageAddress, 1);
+	return val;
+}
+
+void ASKRmtHost_StorageWrite(uint16_t addr, uint8_t val)
+{
+	HostStorageAddress = addr;
+	if (HostStorageFile < 0)
+		ASKRmtHost_Storage[addr] = val;
+	else if (pwrite(HostStorageFile, &val, 1, addr) != 1)
+		perror("ASKRmtHost_StorageWrite");
+}
+
+void ASKRmtHost_StorageReadBlock(void *dst, uint16_t addr, uint16_t n)
+{
+	if (HostStorageFile < 0)
+	{
+		memcpy(dst, &ASKRmtHost_Storage[addr], n);
+		return;
+	}
+	ssize_t r = pread(HostStorageFile, dst, n, addr);
+	if (r < 0) r = 0;
+	memset((uint8_t *)dst + r, 0xFF, n - r); // reads as erased if the file can not be read
+}
+
+void ASKRmtHost_StorageUpdateBlock(const void *src, uint16_t addr, uint16_t n)
+{
+	const uint8_t *bytes = (const uint8_t *)src;
+	for (uint16_t i = 0; i < n; i++)
+		if (ASKRmtHost_StorageRead(addr + i) != bytes[i]) ASKRmtHost_StorageWrite(addr + i, bytes[i]);
+}
+
+void ASKRmtHost_FeedEdge(uint64_t time, uint8_t level)
+{
+	#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+	// the emulated EEPROM is always ready, so the interrupt is raised until the write queue is empty
+	while (HostStorageReadyInterrupt) ASKRmt_EEPROMReadyInterrupt();
+	#endif
+	#ifdef ASKRmt_INPUTCAPTURE
+	if (HostTimeoutRunning && (time >= HostTimeoutTime))
+	{
+		HostTime = HostTimeoutTime;
+		ASKRmt_InputCaptureTimeoutInterrupt();
+	}
+	HostTime = time;
+	if ((0 != level) != HostCaptureRaise) return; // the edge is not selected
+	ASKRmt_InputCaptureInterrupt();
+	#else
+	// raise the overflow interrupts that occur before the signal change
+	while (HostTimerRunning && (time - HostTimerBase > 0xFFFF))
+	{
+		HostTime = HostTimerBase + 0x10000;
+		HostTimerBase = HostTime; // the counter wraps to 0
+		ASKRmt_TwoByte1MHzTimerOverflowInterrupt();
+	}
+	HostTime = time;
+	ASKRmt_RFSignalPinChanged(level);
+	#endif
+}
+
+void ASKRmtHost_FeedEdges(const ASKRmtHost_Edge *edges, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		ASKRmtHost_FeedEdge(edges[i].Time, edges[i].Level);
+}
+
+#endif
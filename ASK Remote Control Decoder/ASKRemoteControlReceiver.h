@@ -0,0 +1,702 @@
+/*
+ * ASKRemoteControlReceiver.h
+ *  ASK RF remote controls decoder instances. A receiver is a class whose timer, pin, storage and policy are template
+ *  parameters, so one firmware can decode several receivers or save remote controls and key codes to separate
+ *  storage regions. ASKRmt_PortReceivers decodes the receivers of several pins of one port with one pin change
+ *  interrupt and one free-running timer. The header only uses ASKRemoteControlCore.h and requires C++17.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRemoteControlReceiver_H_
+#define ASKRemoteControlReceiver_H_
+
+#if __cplusplus < 201703L
+#error "ASKRemoteControlReceiver.h requires C++17 (avr-gcc 7 or later with -std=gnu++17)."
+#endif
+
+#include "ASKRemoteControlCore.h"
+
+/* Codes that a receiver saves to its storage, the SaveMode of its policy.     */
+#define ASKRmt_SAVE_NONE    0 // nothing is saved, the storage is not used
+#define ASKRmt_SAVE_REMOTES 1 // remote controls, like ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+#define ASKRmt_SAVE_KEYS    2 // key codes, like ASKRmt_SAVEKEYCODESTOEEPROM
+
+/* Result bit of ASKRmt_Receiver::SignalChanged and SignalLost: a frame is
+   added to the receive queue. It is not set for the frames that are dropped
+   or discarded.                                                               */
+#define ASKRmt_EDGE_QUEUED 4
+
+/* Keeps the compiler from moving the memory accesses of the receive queues
+   across the update of their indexes.                                         */
+static inline void ASKRmt_MemoryBarrier(void)
+{
+	__asm__ __volatile__("" ::: "memory");
+}
+
+/* Storage of a receiver that does not save codes.                             */
+struct ASKRmt_NoStorage
+{
+	static constexpr uint16_t Start = 0;
+	static constexpr uint16_t End = 0;
+	static uint8_t Read(uint16_t) { return 0xFF; }
+	static void Write(uint16_t, uint8_t) {}
+};
+
+/* Timer of a receiver whose signal changes are timed by the caller of
+   SignalChanged and SignalLost.                                               */
+struct ASKRmt_NoTimer
+{
+	static void Start(void) {}
+	static void Stop(void) {}
+	static uint16_t Value(void) { return 0; }
+	static void Reset(void) {}
+};
+
+/* Kept packets of the soft combining of the decoders of a receiver. They are
+   only allocated if the policy enables soft combining.                        */
+template <uint8_t Count, bool Enabled> struct ASKRmt_Combiners
+{
+	ASKRmt_Combiner Combiner[Count];
+	ASKRmt_Combiner *Get(uint8_t i) { return &Combiner[i]; }
+};
+
+template <uint8_t Count> struct ASKRmt_Combiners<Count, false>
+{
+	ASKRmt_Combiner *Get(uint8_t) { return 0; }
+};
+
+/* One receiver of ASK RF remote controls. Each receiver has its own decoders,
+   receive queue and storage region.
+   Timer:   a 2-byte 1MHz timer, the static functions Start, Stop, Value and
+            Reset like the ASKRmt_2BYTE1MHZTIMER_* definitions.
+   Pin:     the RF signal pin, the static function Read that returns its value.
+   Storage: the static constexpr addresses Start and End (inclusive) and the
+            static functions Read(address) and Write(address, value). It is not
+            used if the SaveMode of the policy is ASKRmt_SAVE_NONE.
+   Policy:  the static constexpr members
+            Protocols:          array of the descriptors of the decoded
+                                protocols (see ASKRemoteControlCore.h)
+            SaveMode:           ASKRmt_SAVE_* value
+            QueueSize:          slots of the receive queue, a power of 2
+            SoftCombining:      true to combine the repeats of a frame
+            AutoDiscardUnsaved: initial value of AutoDiscardUnsaved
+   The frame format (ASKRmt_MAXFRAMEBITS) and ASKRmt_ADAPTIVETIMING are
+   shared by all receivers. A code is saved in 3 bytes like the simple store
+   of the decoder and byte 3 of a free slot is 0xFF. The index, the sorted and
+   journaled stores and the event dispatch of the decoder are not available to
+   receivers.                                                                  */
+template <typename Timer, typename Pin, typename Storage, typename Policy> class ASKRmt_Receiver
+{
+public:
+	static constexpr uint8_t ProtocolCount = sizeof(Policy::Protocols) / sizeof(Policy::Protocols[0]);
+	static constexpr uint8_t QueueSize = Policy::QueueSize;
+	static constexpr uint8_t SlotCount = (ASKRmt_SAVE_NONE == Policy::SaveMode) ? 0 : (Storage::End - Storage::Start + 1) / 3;
+
+	static_assert(ProtocolCount > 0, "A receiver decodes at least one protocol.");
+	static_assert((Policy::QueueSize >= 2) && (Policy::QueueSize <= 128) && !(Policy::QueueSize & (Policy::QueueSize - 1)), "QueueSize must be a power of 2 from 2 to 128.");
+	static_assert((ASKRmt_SAVE_NONE == Policy::SaveMode) || (ASKRmt_SAVE_REMOTES == Policy::SaveMode) || (ASKRmt_SAVE_KEYS == Policy::SaveMode), "SaveMode must be an ASKRmt_SAVE_* value.");
+	static_assert((ASKRmt_SAVE_NONE == Policy::SaveMode) || ((Storage::End >= Storage::Start + 2) && (Storage::End - Storage::Start + 1) / 3 <= 254), "The storage must hold 1 to 254 codes of 3 bytes.");
+
+	/* If it is true, the frames whose codes are not saved are discarded in the
+	   interrupt. Assign false to it before saving codes.                      */
+	volatile bool AutoDiscardUnsaved = Policy::AutoDiscardUnsaved;
+
+	/* Number of frames that were dropped because the receive queue was full.  */
+	volatile uint8_t Overflows = 0;
+
+	ASKRmt_Receiver(void)
+	{
+		for (uint8_t i = 0; i < ProtocolCount; i++)
+		{
+			ASKRmt_DecoderState state = ASKRmt_DECODERSTATE_INIT(Combiners.Get(i));
+			States[i] = state;
+		}
+	}
+
+	/* Call it from the pin change interrupt of the RF signal pin.             */
+	void PinChanged(void)
+	{
+		uint16_t tim = Timer::Value(); // atomic read/write is not needed inside ISR
+		Timer::Reset();
+		if (SignalChanged(Pin::Read(), tim) & ASKRmt_EDGE_STARTTIMER) Timer::Start();
+	}
+
+	/* Call it from the overflow interrupt of the timer.                       */
+	void TimerOverflow(void)
+	{
+		Timer::Stop();
+		SignalLost();
+	}
+
+	/* Decodes a change of the RF signal pin to "pinValue" that is "tim"
+	   microseconds after the previous change, for a front end that times the
+	   changes itself. Returns the combined results of ASKRmt_DecodeEdge and
+	   ASKRmt_EDGE_QUEUED, the front end must count the timeout of 65536
+	   microseconds if ASKRmt_EDGE_STARTTIMER is set.                          */
+	uint8_t SignalChanged(uint8_t pinValue, uint16_t tim)
+	{
+		return DecodeProtocols<0>(pinValue, tim);
+	}
+
+	/* Ends the frames of less than MaxBits bits and resets the decoders after
+	   65536 microseconds without a signal change. Returns ASKRmt_EDGE_QUEUED
+	   if a frame is added to the receive queue.                               */
+	uint8_t SignalLost(void)
+	{
+		return ResetProtocols<0>();
+	}
+
+	/* Returns true if valid data is received.
+	   This function will not pick the data.                                   */
+	bool IsDataReceived(void)
+	{
+		return (GetHeadFrame() != 0);
+	}
+
+	/* Discards the received data.                                             */
+	void DiscardData(void)
+	{
+		if (GetHeadFrame()) PopHeadFrame();
+	}
+
+	/* Reads the data and returns true if valid data is received. The received
+	   data (ASKRmt_DATA_SIZE bytes) will be copied to the "data" array.
+	   This function will not pick the data.                                   */
+	bool GetData(uint8_t *data)
+	{
+		Frame *frame = GetHeadFrame();
+		if (!frame) return false;
+		for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) data[i] = frame->Data[i];
+		return true;
+	}
+
+	/* Picks the data and returns true if valid data is received.              */
+	bool PickData(uint8_t *data)
+	{
+		if (!GetData(data)) return false;
+		PopHeadFrame();
+		return true;
+	}
+
+	/* Returns the key number if valid data is received, otherwise returns -1.
+	   This function will not pick the data.                                   */
+	int8_t GetKey(bool isFixCode)
+	{
+		Frame *frame = GetHeadFrame();
+		if (frame) return FrameKey(frame, isFixCode);
+		return -1;
+	}
+
+	/* Picks the data and returns the key number if valid data is received,
+	   otherwise returns -1.                                                   */
+	int8_t PickKey(bool isFixCode)
+	{
+		int8_t r = GetKey(isFixCode);
+		if (r >= 0) PopHeadFrame();
+		return r;
+	}
+
+	/* Returns the ASKRmt_PROTOCOLID_* value of the protocol of the received
+	   data if valid data is received, otherwise returns -1.
+	   This function will not pick the data.                                   */
+	int8_t GetProtocol(void)
+	{
+		Frame *frame = GetHeadFrame();
+		if (frame) return frame->Protocol;
+		return -1;
+	}
+
+	/* Returns the number of bits of the received data if valid data is
+	   received, otherwise returns -1.
+	   This function will not pick the data.                                   */
+	int8_t GetDataBits(void)
+	{
+		Frame *frame = GetHeadFrame();
+		if (frame) return frame->Bits;
+		return -1;
+	}
+
+	/* Returns the key number if valid data is received and the remote control
+	   code is saved, otherwise returns -1. The type of remote control is the
+	   type it was saved with.
+	   This function will not pick the data.                                   */
+	int8_t GetKeyIfRemoteSaved(void)
+	{
+		static_assert(ASKRmt_SAVE_REMOTES == Policy::SaveMode, "The receiver does not save remote controls.");
+		Frame *frame = GetHeadFrame();
+		if (frame && IsFrameSaved(frame)) return FrameKey(frame, frame->IsFixCode);
+		return -1;
+	}
+
+	/* Saves the remote control code if valid data is received. This function
+	   returns false if no valid data is received or the code is already saved
+	   or the storage is full.
+	   This function will not pick the data.                                   */
+	bool SaveRemote(bool isFixCode)
+	{
+		static_assert(ASKRmt_SAVE_REMOTES == Policy::SaveMode, "The receiver does not save remote controls.");
+		Frame *frame = GetHeadFrame();
+		if (!frame || IsFrameSaved(frame)) return false;
+		const uint8_t *data = FrameCode(frame);
+		uint8_t code[3] = { data[0], data[1], (uint8_t)(isFixCode ? 1 : (data[2] & 0xF0)) };
+		return StoreCode(code);
+	}
+
+	/* Saves the remote control code if valid data is received. The type of
+	   remote control will be detected automatically. The user must only press
+	   key 1 or A.
+	   This function will not pick the data.                                   */
+	bool SaveRemoteAutoDetectType(void)
+	{
+		Frame *frame = GetHeadFrame();
+		if (!frame) return false;
+		uint8_t key = FrameCode(frame)[2] & 0xF;
+		if (0b0001 == key) return SaveRemote(false);
+		if (0b0011 == key) return SaveRemote(true);
+		return false;
+	}
+
+	/* Returns true if valid data is received and the key code is saved,
+	   otherwise returns false. The 3rd byte of the code will be stored to the
+	   variable pointed by the "key" parameter.
+	   This function will not pick the data.                                   */
+	bool GetKeyIfKeySaved(uint8_t *key)
+	{
+		static_assert(ASKRmt_SAVE_KEYS == Policy::SaveMode, "The receiver does not save key codes.");
+		Frame *frame = GetHeadFrame();
+		if (!frame || !IsFrameSaved(frame)) return false;
+		*key = FrameCode(frame)[2];
+		return true;
+	}
+
+	/* Saves the key code if valid data is received. This function returns
+	   false if no valid data is received or the code is already saved or the
+	   storage is full.
+	   This function will not pick the data.                                   */
+	bool SaveKey(void)
+	{
+		static_assert(ASKRmt_SAVE_KEYS == Policy::SaveMode, "The receiver does not save key codes.");
+		Frame *frame = GetHeadFrame();
+		if (!frame || IsFrameSaved(frame)) return false;
+		return StoreCode(FrameCode(frame));
+	}
+
+	/* Deletes the saved remote control or key code of the received data. This
+	   function returns false if no valid data is received or the code is not
+	   saved.
+	   This function will not pick the data.                                   */
+	bool DeleteSaved(void)
+	{
+		static_assert(ASKRmt_SAVE_NONE != Policy::SaveMode, "The receiver does not save codes.");
+		Frame *frame = GetHeadFrame();
+		if (!frame || !IsFrameSaved(frame)) return false;
+		Storage::Write(SlotAddress(frame->Slot) + 2, 0xFF);
+		InvalidateQueuedLookups();
+		return true;
+	}
+
+	/* Deletes all of the saved codes.                                         */
+	void DeleteAllSaved(void)
+	{
+		static_assert(ASKRmt_SAVE_NONE != Policy::SaveMode, "The receiver does not save codes.");
+		for (uint8_t slot = 0; slot < SlotCount; slot++)
+			if (0xFF != Storage::Read(SlotAddress(slot) + 2)) Storage::Write(SlotAddress(slot) + 2, 0xFF);
+		InvalidateQueuedLookups();
+	}
+
+	/* Reads the saved code of the slot "index" and copies its 3 bytes to the
+	   "code" array. Returns false if the index is out of range. A free slot
+	   has 0xFF in its 3rd byte.                                               */
+	bool GetSavedCodeByIndex(uint8_t index, uint8_t *code)
+	{
+		static_assert(ASKRmt_SAVE_NONE != Policy::SaveMode, "The receiver does not save codes.");
+		if (index >= SlotCount) return false;
+		ReadSlot(index, code);
+		return true;
+	}
+
+private:
+	static constexpr uint8_t NO_SLOT = 0xFF;
+
+	/* One decoded frame of the receive queue.                                 */
+	struct Frame
+	{
+		uint8_t Data[ASKRmt_DATA_SIZE]; // received code, in the last bits
+		uint8_t Bits;      // number of bits of the code
+		#if ASKRmt_DATA_SIZE > 3
+		uint8_t Code[3];   // 3-byte code of the frame (see ASKRmt_FoldCode)
+		#endif
+		uint8_t Protocol;  // ASKRmt_PROTOCOLID_* value of the protocol
+		bool    IsSaved;   // the lookup found the code, false if it is not looked up
+		bool    IsFixCode; // type of the saved remote control
+		uint8_t Slot;      // slot of the saved code
+	};
+
+	ASKRmt_Combiners<ProtocolCount, Policy::SoftCombining> Combiners = {};
+	ASKRmt_DecoderState States[ProtocolCount];
+	Frame Queue[Policy::QueueSize];
+	volatile uint8_t QueueHead = 0;
+	volatile uint8_t QueueTail = 0; // the tail slot is always free
+
+	static const uint8_t *FrameCode(const Frame *frame)
+	{
+		#if ASKRmt_DATA_SIZE > 3
+		return frame->Code;
+		#else
+		return frame->Data;
+		#endif
+	}
+
+	static int8_t FrameKey(const Frame *frame, bool isFixCode)
+	{
+		if (isFixCode)
+		{
+			uint8_t value, ones;
+			ASKRmt_DecodeTritByte(FrameCode(frame)[2], &value, &ones);
+			return ones;
+		}
+		return FrameCode(frame)[2] & 0xF;
+	}
+
+	/* Publishes the frame of the protocol P in the tail slot of the queue.
+	   Returns ASKRmt_EDGE_QUEUED if it is not dropped or discarded.           */
+	template <uint8_t P> uint8_t PublishFrame(uint8_t tail)
+	{
+		constexpr ASKRmt_Protocol p = Policy::Protocols[P];
+		Frame *frame = &Queue[tail];
+		uint8_t next = (tail + 1) & (Policy::QueueSize - 1);
+		if (next == QueueHead) // drop the frame if the queue is full
+		{
+			if (255 != Overflows) Overflows++;
+			return ASKRmt_EDGE_NONE;
+		}
+		frame->Bits = (p.MinBits == p.MaxBits) ? p.MaxBits : States[P].FrameBits;
+		frame->Protocol = p.Id;
+		#if ASKRmt_DATA_SIZE > 3
+		ASKRmt_FoldCode(p, frame->Data, frame->Code);
+		#endif
+		frame->IsSaved = false;
+		if constexpr (ASKRmt_SAVE_NONE != Policy::SaveMode)
+		{
+			if (AutoDiscardUnsaved && !LookUpFrame(frame)) return ASKRmt_EDGE_NONE;
+		}
+		ASKRmt_MemoryBarrier(); // the frame must be complete before it is published
+		QueueTail = next;
+		return ASKRmt_EDGE_QUEUED;
+	}
+
+	/* Decodes a change of the RF signal pin with the decoders of the protocols
+	   from P to the end of the table. The unused decoders are not compiled.   */
+	template <uint8_t P> uint8_t DecodeProtocols(uint8_t pinValue, uint16_t tim)
+	{
+		if constexpr (P < ProtocolCount)
+		{
+			constexpr ASKRmt_Protocol p = Policy::Protocols[P];
+			static_assert(ASKRmt_IsValidProtocol(p), "The protocol can not be decoded by ASKRmt_DecodeEdge.");
+			static_assert(p.MaxBits <= ASKRmt_MAXFRAMEBITS, "The frames of the protocol are longer than ASKRmt_MAXFRAMEBITS.");
+			uint8_t tail = QueueTail;
+			uint8_t r = ASKRmt_DecodeEdge(p, &States[P], Queue[tail].Data, pinValue, tim);
+			if (r & ASKRmt_EDGE_FRAME) r |= PublishFrame<P>(tail);
+			return r | DecodeProtocols<P + 1>(pinValue, tim);
+		}
+		else
+			return ASKRmt_EDGE_NONE;
+	}
+
+	/* Publishes the frames that the timeout ends and resets the decoders of
+	   the protocols from P to the end of the table. Returns
+	   ASKRmt_EDGE_QUEUED if a frame is added to the receive queue.            */
+	template <uint8_t P> uint8_t ResetProtocols(void)
+	{
+		if constexpr (P < ProtocolCount)
+		{
+			constexpr ASKRmt_Protocol p = Policy::Protocols[P]; // the table is not read at run time
+			uint8_t tail = QueueTail, r = ASKRmt_EDGE_NONE;
+			if (ASKRmt_DecodeTimeout(p, &States[P], Queue[tail].Data) & ASKRmt_EDGE_FRAME) r = PublishFrame<P>(tail);
+			ASKRmt_ResetDecoder(&States[P]);
+			return r | ResetProtocols<P + 1>();
+		}
+		else
+			return ASKRmt_EDGE_NONE;
+	}
+
+	Frame *GetHeadFrame(void)
+	{
+		if (QueueHead == QueueTail) return 0;
+		ASKRmt_MemoryBarrier(); // the frame must be read after QueueTail
+		return &Queue[QueueHead];
+	}
+
+	void PopHeadFrame(void)
+	{
+		ASKRmt_MemoryBarrier(); // the frame must be read before it is released
+		QueueHead = (QueueHead + 1) & (Policy::QueueSize - 1);
+	}
+
+	/* Clears the cached lookup results of the queued frames after the saved
+	   codes are changed.                                                      */
+	void InvalidateQueuedLookups(void)
+	{
+		uint8_t tail = QueueTail;
+		ASKRmt_MemoryBarrier(); // the frames must be written after QueueTail is read
+		for (uint8_t i = QueueHead; i != tail; i = (i + 1) & (Policy::QueueSize - 1)) Queue[i].IsSaved = false;
+	}
+
+	static uint16_t SlotAddress(uint8_t slot)
+	{
+		return Storage::Start + 3 * slot;
+	}
+
+	static void ReadSlot(uint8_t slot, uint8_t *code)
+	{
+		uint16_t address = SlotAddress(slot);
+		for (uint8_t i = 0; i < 3; i++) code[i] = Storage::Read(address + i);
+	}
+
+	/* Returns true if the saved code "code" is the code of the frame "data".
+	   A FixCode remote control is matched by its address and a LearningCode
+	   remote control also by the high nibble of its 3rd byte.                 */
+	static bool IsCodeMatch(const uint8_t *code, const uint8_t *data)
+	{
+		if (0xFF == code[2]) return false;
+		if ((code[0] != data[0]) || (code[1] != data[1])) return false;
+		if constexpr (ASKRmt_SAVE_REMOTES == Policy::SaveMode)
+		{
+			// least significant nibble of 3rd byte is the remote control type (0:LearningCode, 1:FixCode)
+			if (code[2] & 1) return true;
+			return ((code[2] & 0xF0) == (data[2] & 0xF0));
+		}
+		else
+			return (code[2] == data[2]);
+	}
+
+	/* Looks the code of the frame up in the storage. Returns true and keeps
+	   the slot if it is saved.                                                */
+	bool LookUpFrame(Frame *frame)
+	{
+		uint8_t code[3];
+		for (uint8_t slot = 0; slot < SlotCount; slot++)
+		{
+			ReadSlot(slot, code);
+			if (IsCodeMatch(code, FrameCode(frame)))
+			{
+				frame->Slot = slot;
+				frame->IsFixCode = (code[2] & 1);
+				frame->IsSaved = true;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool IsFrameSaved(Frame *frame)
+	{
+		return frame->IsSaved || LookUpFrame(frame);
+	}
+
+	/* Saves the code to a free slot. Returns false if the storage is full.    */
+	bool StoreCode(const uint8_t *code)
+	{
+		if (0xFF == code[2]) return false; // it would be a free slot
+		for (uint8_t slot = 0; slot < SlotCount; slot++)
+		{
+			if (0xFF != Storage::Read(SlotAddress(slot) + 2)) continue;
+			uint16_t address = SlotAddress(slot);
+			Storage::Write(address, code[0]);
+			Storage::Write(address + 1, code[1]);
+			Storage::Write(address + 2, code[2]); // the slot is used when its last byte is written
+			InvalidateQueuedLookups();
+			return true;
+		}
+		return false;
+	}
+};
+
+/* Returns the smallest power of 2 that is at least "n".                       */
+constexpr uint16_t ASKRmt_PowerOf2(uint16_t n, uint16_t p = 1)
+{
+	return (p >= n) ? p : ASKRmt_PowerOf2(n, 2 * p);
+}
+
+/* Front end of several receivers whose RF signal pins are on one port. One
+   pin change interrupt serves all of them: the pins that toggled are found by
+   XOR with the previous snapshot of the port, and the changes are timed with
+   one free-running timer, so the receivers do not need a timer each. Only the
+   receivers of the toggled pins decode, so the interrupt checks one bit for
+   each other receiver. The frames are kept in the queues of the receivers and
+   the order of all frames is kept in a queue of their channel numbers.
+   Port:      the static function Read that returns the value of the port and
+              the static constexpr array Pins, the bit number of the pin of
+              each receiver.
+   Clock:     a free-running 2-byte 1MHz timer, the static functions Value,
+              IsOverflowPending and ClearOverflow.
+   Receivers: the ASKRmt_Receiver instances, channel 0 first. Their own
+              timers and pins are not used, so use ASKRmt_NoTimer.
+   A decoder whose signal is lost is reset 65536 to 131072 microseconds after
+   the last change of its pin, on the second overflow of the clock.
+   Pick the frames with PickData, or with PickChannel and then the receiver
+   of the channel. A frame that is picked from a receiver without its channel
+   leaves the channel in the queue of the channels, which PickData skips.      */
+template <typename Port, typename Clock, auto &... Receivers> class ASKRmt_PortReceivers
+{
+public:
+	static constexpr uint8_t ChannelCount = sizeof...(Receivers);
+	static constexpr uint16_t OrderSize = ASKRmt_PowerOf2((Receivers.QueueSize + ...));
+
+	static_assert((ChannelCount > 0) && (ChannelCount <= 8) && (sizeof(Port::Pins) == ChannelCount), "Port::Pins must have a pin for each receiver.");
+	static_assert(OrderSize <= 256, "The receive queues of the receivers must have up to 256 slots together.");
+
+	/* Number of channels that were dropped because the queue of the channels
+	   was full.                                                               */
+	volatile uint8_t Overflows = 0;
+
+	/* Call it from the pin change interrupt of the pins.                      */
+	void PinsChanged(void)
+	{
+		uint16_t now = Clock::Value();
+		// the overflow interrupt waits while this one runs, handle it first if it occurred before the clock was read
+		if (Clock::IsOverflowPending() && !(now & 0x8000))
+		{
+			Clock::ClearOverflow();
+			ClockOverflow();
+		}
+		uint8_t port = Port::Read();
+		uint8_t changed = port ^ Snapshot;
+		Snapshot = port;
+		if (changed) DecodeChannels<0, Receivers...>(port, changed, now);
+	}
+
+	/* Call it from the overflow interrupt of the clock.                       */
+	void ClockOverflow(void)
+	{
+		TimeoutChannels<0, Receivers...>();
+	}
+
+	/* Returns the channel of the oldest received frame of all receivers, or
+	   -1 if no frame is received. The frame is the oldest frame of the
+	   receiver of the channel.
+	   This function will not pick the channel.                                */
+	int8_t GetChannel(void)
+	{
+		if (OrderHead == OrderTail) return -1;
+		ASKRmt_MemoryBarrier(); // the channel must be read after OrderTail
+		return Order[OrderHead];
+	}
+
+	/* Picks the channel of the oldest received frame of all receivers and
+	   returns it, or returns -1 if no frame is received. Pick or discard the
+	   frame with the receiver of the channel afterwards.                      */
+	int8_t PickChannel(void)
+	{
+		int8_t channel = GetChannel();
+		if (channel >= 0)
+		{
+			ASKRmt_MemoryBarrier(); // the channel must be read before it is released
+			OrderHead = (OrderHead + 1) & (OrderSize - 1);
+		}
+		return channel;
+	}
+
+	/* Picks the oldest received frame of all receivers and returns its
+	   channel, or returns -1 if no frame is received. The received data
+	   (ASKRmt_DATA_SIZE bytes) will be copied to the "data" array.            */
+	int8_t PickData(uint8_t *data)
+	{
+		int8_t channel;
+		while ((channel = PickChannel()) >= 0)
+			if (PickChannelData<0, Receivers...>(channel, data)) break; // otherwise the frame was picked from the receiver
+		return channel;
+	}
+
+private:
+	/* Timing of the changes of one channel.                                   */
+	struct Channel
+	{
+		uint16_t Last;    // clock value of the last change
+		uint8_t  Age;     // clock overflows since the last change
+		bool     Running; // the timeout of the channel is counted, like the timer of the pin change front end
+	};
+
+	Channel Channels[ChannelCount] = {};
+	uint8_t Snapshot = 0;
+	uint8_t Order[OrderSize];  // channels of the received frames, the oldest first
+	volatile uint8_t OrderHead = 0;
+	volatile uint8_t OrderTail = 0;
+
+	/* Adds a channel to the queue of the channels. The receivers keep at most
+	   QueueSize - 1 frames each, so it is only full if frames were picked from
+	   the receivers without their channels. Then the channel is dropped and
+	   counted in Overflows.                                                   */
+	void PushChannel(uint8_t channel)
+	{
+		uint8_t tail = OrderTail;
+		if (((tail + 1) & (OrderSize - 1)) == OrderHead)
+		{
+			if (255 != Overflows) Overflows++;
+			return;
+		}
+		Order[tail] = channel;
+		ASKRmt_MemoryBarrier(); // the channel must be written before it is published
+		OrderTail = (tail + 1) & (OrderSize - 1);
+	}
+
+	/* Decodes the changes of the toggled pins of the channels from C to the
+	   end with their receivers.                                               */
+	template <uint8_t C, auto &Receiver, auto &... Rest> void DecodeChannels(uint8_t port, uint8_t changed, uint16_t now)
+	{
+		constexpr uint8_t mask = 1 << Port::Pins[C];
+		if (changed & mask)
+		{
+			Channel *channel = &Channels[C];
+			uint16_t tim = 0; // the stopped timer of the pin change front end reads 0
+			if (channel->Running)
+			{
+				if (channel->Age && (now >= channel->Last)) // 65536 microseconds or more after the last change
+				{
+					if (Receiver.SignalLost() & ASKRmt_EDGE_QUEUED) PushChannel(C);
+					channel->Running = false;
+				}
+				else
+					tim = now - channel->Last; // the clock is never reset, so the difference wraps correctly
+			}
+			uint8_t r = Receiver.SignalChanged((port & mask) ? 1 : 0, tim);
+			if (r & ASKRmt_EDGE_STARTTIMER) channel->Running = true;
+			if (r & ASKRmt_EDGE_QUEUED) PushChannel(C);
+			channel->Last = now;
+			channel->Age = 0;
+		}
+		if constexpr (sizeof...(Rest) > 0) DecodeChannels<C + 1, Rest...>(port, changed, now);
+	}
+
+	/* Picks the frame of the receiver of "channel" from the receivers of the
+	   channels from C to the end. Returns false if it has no frame.           */
+	template <uint8_t C, auto &Receiver, auto &... Rest> bool PickChannelData(uint8_t channel, uint8_t *data)
+	{
+		if (C == channel) return Receiver.PickData(data);
+		if constexpr (sizeof...(Rest) > 0) return PickChannelData<C + 1, Rest...>(channel, data);
+		return false;
+	}
+
+	/* Counts an overflow of the clock for the channels from C to the end and
+	   resets the decoders of the channels whose signal is lost.               */
+	template <uint8_t C, auto &Receiver, auto &... Rest> void TimeoutChannels(void)
+	{
+		Channel *channel = &Channels[C];
+		if (channel->Running && (++channel->Age >= 2)) // the last change is more than 65536 microseconds old
+		{
+			if (Receiver.SignalLost() & ASKRmt_EDGE_QUEUED) PushChannel(C);
+			channel->Running = false;
+		}
+		if constexpr (sizeof...(Rest) > 0) TimeoutChannels<C + 1, Rest...>();
+	}
+};
+
+#endif /* ASKRemoteControlReceiver_H_ */
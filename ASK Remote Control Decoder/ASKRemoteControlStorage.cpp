@@ -0,0 +1,254 @@
+/*
+ * ASKRemoteControlStorage.cpp
+ *  Storages of the saved remote controls or keys of the ASK RF remote controls signal decoder other than the internal
+ *  EEPROM: an area of the program flash that is written with SPM (ASKRmt_STORAGE_FLASH) and an external 24Cxx I2C
+ *  EEPROM on the TWI pins (ASKRmt_STORAGE_I2CEEPROM). The internal EEPROM is bound to avr-libc in
+ *  ASKRemoteControlHAL.h. Add this file to the project if one of these storages is selected.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include "ASKRemoteControlDecoder.h"
+#include "ASKRemoteControlHAL.h"
+
+#if defined(__AVR__) && defined(ASKRmt_STORAGE_FLASH)
+
+#include <string.h>
+#include <avr/pgmspace.h>
+#include <avr/boot.h>
+
+#if ASKRmt_FLASHSTORE_SIZE % SPM_PAGESIZE
+#error "ASKRmt_FLASHSTORE_SIZE must be a multiple of the flash page size."
+#endif
+
+#if (ASKRmt_EEPROM_END >= ASKRmt_FLASHSTORE_SIZE) || (ASKRmt_EEPROM_GENERATION >= ASKRmt_FLASHSTORE_SIZE)
+#error "ASKRmt_FLASHSTORE_SIZE must contain ASKRmt_EEPROM_END and ASKRmt_EEPROM_GENERATION."
+#endif
+
+/* Flash area of the storage. The array is programmed with the program and an
+   erased storage byte must be 0xFF, so the bytes are stored inverted and the
+   zeros of the array are erased bytes.                                        */
+const uint8_t FlashStore[ASKRmt_FLASHSTORE_SIZE] PROGMEM __attribute__((aligned(SPM_PAGESIZE))) = { 0 };
+
+uint8_t ASKRmtFlash_Read(uint16_t addr)
+{
+	return ~pgm_read_byte(&FlashStore[addr]);
+}
+
+void ASKRmtFlash_ReadBlock(void *dst, uint16_t addr, uint16_t n)
+{
+	uint8_t *bytes = (uint8_t *)dst;
+	for (uint16_t i = 0; i < n; i++) bytes[i] = ~pgm_read_byte(&FlashStore[addr + i]);
+}
+
+/* Erases a flash page and writes "data" to it. SPM only works in the boot
+   loader section and the application section can not be read until the
+   write is finished, so this function is placed in the boot loader section,
+   must be called with the interrupts disabled and must not call functions.    */
+BOOTLOADER_SECTION void FlashWritePage(uint16_t page, const uint8_t *data)
+{
+	eeprom_busy_wait(); // SPM must not run during an EEPROM write
+	boot_page_erase(page);
+	boot_spm_busy_wait();
+	for (uint8_t i = 0; i < SPM_PAGESIZE; i += 2)
+		boot_page_fill(page + i, data[i] | (data[i + 1] << 8));
+	boot_page_write(page);
+	boot_spm_busy_wait();
+	boot_rww_enable();
+}
+
+/* Writes the pages that have changed bytes. Each page is erased and rewritten
+   with the interrupts disabled (about 9 milliseconds on ATmega8A).            */
+void ASKRmtFlash_UpdateBlock(const void *src, uint16_t addr, uint16_t n)
+{
+	const uint8_t *bytes = (const uint8_t *)src;
+	uint8_t page[SPM_PAGESIZE];
+	while (n)
+	{
+		uint16_t base = addr & ~(SPM_PAGESIZE - 1);
+		uint16_t offset = addr - base;
+		uint16_t count = SPM_PAGESIZE - offset;
+		if (count > n) count = n;
+		memcpy_P(page, &FlashStore[base], SPM_PAGESIZE);
+		bool changed = false;
+		for (uint16_t i = 0; i < count; i++)
+		{
+			uint8_t val = ~bytes[i];
+			if (page[offset + i] == val) continue;
+			page[offset + i] = val;
+			changed = true;
+		}
+		if (changed)
+		{
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE) FlashWritePage((uint16_t)(uintptr_t)&FlashStore[base], page);
+		}
+		bytes += count;
+		addr += count;
+		n -= count;
+	}
+}
+
+#endif
+
+#if defined(__AVR__) && defined(ASKRmt_STORAGE_I2CEEPROM)
+
+#include <util/twi.h>
+
+#if (ASKRmt_I2CEEPROM_PAGESIZE < 1) || (ASKRmt_I2CEEPROM_PAGESIZE > 256) || (ASKRmt_I2CEEPROM_PAGESIZE & (ASKRmt_I2CEEPROM_PAGESIZE - 1))
+#error "ASKRmt_I2CEEPROM_PAGESIZE must be a power of 2 up to 256."
+#endif
+
+/* Number of times that the device is addressed until it answers. It does not
+   answer while it writes a page (up to 5 milliseconds). A device that does not
+   answer reads as erased.                                                     */
+#define I2C_POLLS 200
+
+static bool I2CWriting = false; // a page write may be in progress
+
+static void I2CWait(void)
+{
+	while (!(TWCR & (1 << TWINT)));
+}
+
+/* Sends a start condition and a device address byte. Returns true if the
+   device acknowledges it.                                                     */
+static bool I2CStart(uint8_t device)
+{
+	TWBR = ASKRmt_I2CEEPROM_TWBR;
+	TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
+	I2CWait();
+	if ((TW_STATUS != TW_START) && (TW_STATUS != TW_REP_START)) return false;
+	TWDR = device;
+	TWCR = (1 << TWINT) | (1 << TWEN);
+	I2CWait();
+	return (TW_STATUS == TW_MT_SLA_ACK) || (TW_STATUS == TW_MR_SLA_ACK);
+}
+
+static bool I2CWrite(uint8_t val)
+{
+	TWDR = val;
+	TWCR = (1 << TWINT) | (1 << TWEN);
+	I2CWait();
+	return (TW_STATUS == TW_MT_DATA_ACK);
+}
+
+/* Reads a byte. The last byte of a read is not acknowledged.                  */
+static uint8_t I2CRead(bool ack)
+{
+	TWCR = (1 << TWINT) | (1 << TWEN) | (ack ? (1 << TWEA) : 0);
+	I2CWait();
+	return TWDR;
+}
+
+static void I2CStop(void)
+{
+	TWCR = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+	while (TWCR & (1 << TWSTO));
+}
+
+/* Device address byte of a storage address. Devices with 1-byte addresses
+   take the bits 8-10 of the address in the device address.                    */
+static uint8_t I2CDevice(uint16_t addr)
+{
+	#ifdef ASKRmt_I2CEEPROM_2BYTEADDRESS
+	(void)addr; // all of the address bits are sent after the device address
+	return ASKRmt_I2CEEPROM_ADDRESS << 1;
+	#else
+	return (ASKRmt_I2CEEPROM_ADDRESS | ((addr >> 8) & 7)) << 1;
+	#endif
+}
+
+/* Sends the storage address of the next read or write. The device is
+   addressed until it answers. Returns false if it does not answer.            */
+static bool I2CSelect(uint16_t addr)
+{
+	for (uint16_t i = 0; i < I2C_POLLS; i++)
+	{
+		bool ack = I2CStart(I2CDevice(addr) | TW_WRITE);
+		if (ack)
+		{
+			I2CWriting = false;
+			#ifdef ASKRmt_I2CEEPROM_2BYTEADDRESS
+			ack = I2CWrite(addr >> 8);
+			#endif
+			if (ack && I2CWrite(addr & 0xFF)) return true;
+		}
+		I2CStop();
+	}
+	return false;
+}
+
+uint8_t ASKRmtI2C_Read(uint16_t addr)
+{
+	uint8_t val;
+	ASKRmtI2C_ReadBlock(&val, addr, 1);
+	return val;
+}
+
+/* Reads with sequential reads that do not cross 256-byte boundaries, where
+   the device address of 1-byte address devices changes.                       */
+void ASKRmtI2C_ReadBlock(void *dst, uint16_t addr, uint16_t n)
+{
+	uint8_t *bytes = (uint8_t *)dst;
+	while (n)
+	{
+		uint16_t count = 256 - (addr & 0xFF);
+		if (count > n) count = n;
+		if (I2CSelect(addr) && I2CStart(I2CDevice(addr) | TW_READ))
+			for (uint16_t i = 0; i < count; i++) bytes[i] = I2CRead(i + 1 < count);
+		else
+			for (uint16_t i = 0; i < count; i++) bytes[i] = 0xFF;
+		I2CStop();
+		bytes += count;
+		addr += count;
+		n -= count;
+	}
+}
+
+/* Writes the changed bytes of each page with one page write from the first
+   to the last changed byte. The device writes the page after the stop
+   condition and the next access waits until it is finished.                   */
+void ASKRmtI2C_UpdateBlock(const void *src, uint16_t addr, uint16_t n)
+{
+	const uint8_t *bytes = (const uint8_t *)src;
+	uint8_t old[ASKRmt_I2CEEPROM_PAGESIZE];
+	while (n)
+	{
+		uint16_t count = ASKRmt_I2CEEPROM_PAGESIZE - (addr & (ASKRmt_I2CEEPROM_PAGESIZE - 1)); // page writes wrap around at the end of the page
+		if (count > n) count = n;
+		ASKRmtI2C_ReadBlock(old, addr, count);
+		uint16_t first = 0, last = count;
+		while ((first < count) && (old[first] == bytes[first])) first++;
+		while ((last > first) && (old[last - 1] == bytes[last - 1])) last--;
+		if (first < last)
+		{
+			if (I2CSelect(addr + first))
+			{
+				for (uint16_t i = first; (i < last) && I2CWrite(bytes[i]); i++);
+				I2CWriting = true;
+			}
+			I2CStop();
+		}
+		bytes += count;
+		addr += count;
+		n -= count;
+	}
+}
+
+/* Returns true if the device is not writing a page.                           */
+bool ASKRmtI2C_IsReady(void)
+{
+	if (!I2CWriting) return true;
+	I2CWriting = !I2CStart(I2CDevice(0) | TW_WRITE);
+	I2CStop();
+	return !I2CWriting;
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * ASKRemoteControlTransfer.cpp
+ *  Device side of the bulk transfer protocol of ASKRemoteControlTransfer.h. It exports the saved remote controls or
+ *  keys in blocks and imports a list of codes with ASKRmt_BeginImport, ASKRmt_ImportCode and ASKRmt_EndImport. Add
+ *  this file to the project to use ASKRmt_TransferReceivedByte.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include "ASKRemoteControlDecoder.h"
+#include "ASKRemoteControlTransfer.h"
+
+#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+
+static ASKRmt_TransferReceiver Receiver;
+
+/* The last exported block is kept, so it can be sent again if the host does
+   not receive it, and the next block continues after it.                      */
+static uint16_t ExportBlock = 0xFFFF;  // number of the last exported block
+static uint16_t ExportStart, ExportNext; // first slot of the last exported block and of the next block
+
+static bool     Importing = false;
+static bool     Imported = false;     // the last import is finished
+static uint16_t ImportBlock;          // number of the next imported block
+
+static bool ReadCode(uint16_t index, uint8_t *code)
+{
+	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+	return ASKRmt_GetRemoteCodeByIndex(index, code);
+	#else
+	return ASKRmt_GetKeyCodeByIndex(index, code);
+	#endif
+}
+
+static void SendStatus(uint8_t type, uint16_t block, uint8_t status, void (*send)(uint8_t byte))
+{
+	uint8_t payload[3] = { (uint8_t)block, (uint8_t)(block >> 8), status };
+	ASKRmt_TransferSend(type, payload, 3, send);
+}
+
+/* Sends the saved codes of the slots from "start" until the block is full.    */
+static void SendExportBlock(uint16_t block, uint16_t start, void (*send)(uint8_t byte))
+{
+	uint8_t payload[ASKRmt_TRANSFER_MAXPAYLOAD] = { (uint8_t)block, (uint8_t)(block >> 8) };
+	uint8_t length = 2;
+	uint16_t slot = start, count = ASKRmt_GetSlotCount();
+	while ((slot < count) && (length < ASKRmt_TRANSFER_MAXPAYLOAD))
+	{
+		ReadCode(slot++, payload + length);
+		if (0xFF != payload[length + 2]) length += 3; // skip the free slots
+	}
+	ExportBlock = block;
+	ExportStart = start;
+	ExportNext = slot;
+	ASKRmt_TransferSend(ASKRmt_TRANSFER_BLOCK, payload, length, send);
+}
+
+static void HandleFrame(const ASKRmt_TransferReceiver *r, void (*send)(uint8_t byte))
+{
+	const uint8_t *p = r->Payload;
+	uint16_t block = (r->Length >= 2) ? (p[0] | (p[1] << 8)) : 0;
+	switch (r->Type)
+	{
+		case ASKRmt_TRANSFER_INFO:
+		{
+			uint16_t count = ASKRmt_GetSlotCount();
+			uint8_t flags = 0;
+			#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+			flags |= ASKRmt_TRANSFER_KEYS;
+			#endif
+			#ifdef ASKRmt_SORTEDSTORE
+			flags |= ASKRmt_TRANSFER_SORTED;
+			#endif
+			uint8_t payload[5] = { (uint8_t)count, (uint8_t)(count >> 8), ASKRmt_TRANSFER_BLOCKCODES, flags, ASKRmt_TRANSFER_VERSION };
+			ASKRmt_TransferSend(ASKRmt_TRANSFER_DEVICE, payload, 5, send);
+			break;
+		}
+		case ASKRmt_TRANSFER_EXPORT:
+			if (2 != r->Length)
+				SendStatus(ASKRmt_TRANSFER_NACK, 0, ASKRmt_TRANSFER_INVALID, send);
+			else if (0 == block)
+				SendExportBlock(0, 0, send);
+			else if (block == ExportBlock) // the response was lost
+				SendExportBlock(block, ExportStart, send);
+			else if (block == (uint16_t)(ExportBlock + 1))
+				SendExportBlock(block, ExportNext, send);
+			else
+				SendStatus(ASKRmt_TRANSFER_NACK, ExportBlock + 1, ASKRmt_TRANSFER_SEQUENCE, send);
+			break;
+		case ASKRmt_TRANSFER_BEGIN:
+			ASKRmt_BeginImport();
+			Importing = true;
+			Imported = false;
+			ImportBlock = 0;
+			SendStatus(ASKRmt_TRANSFER_ACK, 0, ASKRmt_TRANSFER_OK, send);
+			break;
+		case ASKRmt_TRANSFER_CODES:
+			if ((r->Length < 2) || ((r->Length - 2) % 3))
+				SendStatus(ASKRmt_TRANSFER_NACK, ImportBlock, ASKRmt_TRANSFER_INVALID, send);
+			else if (!Importing)
+				SendStatus(ASKRmt_TRANSFER_NACK, ImportBlock, ASKRmt_TRANSFER_NOIMPORT, send);
+			else if (block == (uint16_t)(ImportBlock - 1)) // the acknowledge was lost, the block is already imported
+				SendStatus(ASKRmt_TRANSFER_ACK, block, ASKRmt_TRANSFER_OK, send);
+			else if (block != ImportBlock)
+				SendStatus(ASKRmt_TRANSFER_NACK, ImportBlock, ASKRmt_TRANSFER_SEQUENCE, send);
+			else
+			{
+				for (uint8_t i = 2; i < r->Length; i += 3)
+					if (!ASKRmt_ImportCode(p + i))
+					{
+						Importing = false; // the saved codes are left as they are
+						SendStatus(ASKRmt_TRANSFER_NACK, block, ASKRmt_TRANSFER_REJECTED, send);
+						return;
+					}
+				ImportBlock++;
+				SendStatus(ASKRmt_TRANSFER_ACK, block, ASKRmt_TRANSFER_OK, send);
+			}
+			break;
+		case ASKRmt_TRANSFER_FINISH:
+			if (Importing)
+			{
+				ASKRmt_EndImport();
+				Importing = false;
+				Imported = true;
+			}
+			if (Imported) // also if the acknowledge was lost
+				SendStatus(ASKRmt_TRANSFER_ACK, ImportBlock, ASKRmt_TRANSFER_OK, send);
+			else
+				SendStatus(ASKRmt_TRANSFER_NACK, ImportBlock, ASKRmt_TRANSFER_NOIMPORT, send);
+			break;
+	}
+}
+
+void ASKRmt_TransferReceivedByte(uint8_t byte, void (*send)(uint8_t byte))
+{
+	if (ASKRmt_TransferReceive(&Receiver, byte)) HandleFrame(&Receiver, send);
+}
+
+#endif
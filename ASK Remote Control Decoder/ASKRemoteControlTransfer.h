@@ -0,0 +1,141 @@
+/*
+ * ASKRemoteControlTransfer.h
+ *  Framed binary protocol for the bulk export and import of the saved remote controls or keys over a UART. It does
+ *  not depend on the hardware and is shared by the firmware (ASKRemoteControlTransfer.cpp) and the host tools.
+ *  A frame is the start byte 0xA5, the type, the payload length, the payload and the CRC-16/CCITT (polynomial
+ *  0x1021, initial value 0xFFFF) of the type, the length and the payload, most significant byte first. The host
+ *  sends a request and waits for the response of the device before it sends the next request, and sends the
+ *  request again if there is no valid response, so a lost or damaged frame only costs a retry.
+ *   Info:   'I' ()                   -> 'i' (slot count: 2 bytes, codes per block, flags, protocol version)
+ *   Export: 'E' (block number)       -> 'd' (block number, up to 16 saved codes). A block without codes is the end.
+ *   Import: 'B' ()                   -> 'a' (0, status)
+ *           'C' (block number, codes) -> 'a' (block number, status) after the codes are written
+ *           'F' ()                   -> 'a' (number of blocks, status) after the codes that are not imported are
+ *                                       deleted
+ *  Block numbers are 2 bytes, least significant byte first, and start from 0. A request that can not be done is
+ *  answered by 'n' (expected block number, status).
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRemoteControlTransfer_H_
+#define ASKRemoteControlTransfer_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ASKRmt_TRANSFER_START      0xA5
+#define ASKRmt_TRANSFER_VERSION    1
+#define ASKRmt_TRANSFER_BLOCKCODES 16 // codes per block
+#define ASKRmt_TRANSFER_MAXPAYLOAD (2 + ASKRmt_TRANSFER_BLOCKCODES * 3)
+
+/* Frame types. Requests are upper case and responses are lower case.          */
+#define ASKRmt_TRANSFER_INFO   'I'
+#define ASKRmt_TRANSFER_EXPORT 'E'
+#define ASKRmt_TRANSFER_BEGIN  'B'
+#define ASKRmt_TRANSFER_CODES  'C'
+#define ASKRmt_TRANSFER_FINISH 'F'
+#define ASKRmt_TRANSFER_DEVICE 'i'
+#define ASKRmt_TRANSFER_BLOCK  'd'
+#define ASKRmt_TRANSFER_ACK    'a'
+#define ASKRmt_TRANSFER_NACK   'n'
+
+/* Flags of the info response.                                                 */
+#define ASKRmt_TRANSFER_KEYS   1 // the codes are keys, otherwise remote controls
+#define ASKRmt_TRANSFER_SORTED 2 // the codes must be imported in ascending order
+
+/* Status of the responses.                                                    */
+#define ASKRmt_TRANSFER_OK       0
+#define ASKRmt_TRANSFER_REJECTED 1 // the store is full, a code is invalid or out of order
+#define ASKRmt_TRANSFER_SEQUENCE 2 // unexpected block number
+#define ASKRmt_TRANSFER_NOIMPORT 3 // no import is started
+#define ASKRmt_TRANSFER_INVALID  4 // invalid payload
+
+/* Receiver of frames. Initialize it with zeros.                               */
+typedef struct
+{
+	uint8_t  State; // 0: start, 1: type, 2: length, 3: payload, 4 and 5: CRC
+	uint8_t  Type;
+	uint8_t  Length;
+	uint8_t  Count; // received payload bytes
+	uint16_t CRC;
+	uint16_t Check; // received CRC
+	uint8_t  Payload[ASKRmt_TRANSFER_MAXPAYLOAD];
+} ASKRmt_TransferReceiver;
+
+static inline uint16_t ASKRmt_TransferCRC(uint16_t crc, uint8_t byte)
+{
+	crc ^= (uint16_t)byte << 8;
+	for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+	return crc;
+}
+
+/* Receives one byte. Returns true when a frame with a valid CRC is received.
+   The bytes before a start byte and the frames with a wrong CRC or a too long
+   payload are ignored.                                                        */
+static inline bool ASKRmt_TransferReceive(ASKRmt_TransferReceiver *r, uint8_t byte)
+{
+	switch (r->State)
+	{
+		case 0:
+			if (ASKRmt_TRANSFER_START == byte)
+			{
+				r->CRC = 0xFFFF;
+				r->State = 1;
+			}
+			return false;
+		case 1:
+			r->Type = byte;
+			r->CRC = ASKRmt_TransferCRC(r->CRC, byte);
+			r->State = 2;
+			return false;
+		case 2:
+			if (byte > ASKRmt_TRANSFER_MAXPAYLOAD)
+			{
+				r->State = 0;
+				return false;
+			}
+			r->Length = byte;
+			r->Count = 0;
+			r->CRC = ASKRmt_TransferCRC(r->CRC, byte);
+			r->State = byte ? 3 : 4;
+			return false;
+		case 3:
+			r->Payload[r->Count++] = byte;
+			r->CRC = ASKRmt_TransferCRC(r->CRC, byte);
+			if (r->Count >= r->Length) r->State = 4;
+			return false;
+		case 4:
+			r->Check = (uint16_t)byte << 8;
+			r->State = 5;
+			return false;
+		default:
+			r->State = 0;
+			return ((r->Check | byte) == r->CRC);
+	}
+}
+
+/* Sends a frame with "send".                                                  */
+static inline void ASKRmt_TransferSend(uint8_t type, const uint8_t *payload, uint8_t length, void (*send)(uint8_t byte))
+{
+	uint16_t crc = ASKRmt_TransferCRC(ASKRmt_TransferCRC(0xFFFF, type), length);
+	send(ASKRmt_TRANSFER_START);
+	send(type);
+	send(length);
+	for (uint8_t i = 0; i < length; i++)
+	{
+		send(payload[i]);
+		crc = ASKRmt_TransferCRC(crc, payload[i]);
+	}
+	send(crc >> 8);
+	send(crc & 0xFF);
+}
+
+#endif /* ASKRemoteControlTransfer_H_ */
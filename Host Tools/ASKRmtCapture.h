@@ -0,0 +1,327 @@
+/*
+ * ASKRmtCapture.h
+ *  Capture file reading for the ASK RF remote controls host tools. Capture files are memory-mapped and their signal
+ *  changes are streamed to a sink without loading the file into the RAM. Supported formats:
+ *   raw: little-endian 64-bit words, one per signal change. Bit 63 is the pin value after the change and bits 0-62
+ *        are the time of the change in the selected unit.
+ *   csv: text lines "time,value,..." as exported by logic analyzers. Lines that do not start with a number are
+ *        skipped. The time is a decimal number in the selected unit (seconds by default).
+ *   vcd: Value Change Dump. The first 1-bit variable, or the variable selected by name, is used.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRmtCapture_H_
+#define ASKRmtCapture_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../ASK Remote Control Decoder/ASKRemoteControlCore.h"
+
+enum CaptureFormat { CAPTURE_RAW, CAPTURE_CSV, CAPTURE_VCD };
+
+/* Read-only memory mapping of a whole capture file.                           */
+struct CaptureFile
+{
+	const char *Data = 0;
+	size_t      Size = 0;
+
+	bool Open(const char *path)
+	{
+		int fd = open(path, O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if (fstat(fd, &st) || !S_ISREG(st.st_mode)) { close(fd); return false; }
+		Size = st.st_size;
+		if (Size)
+		{
+			void *p = mmap(0, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (MAP_FAILED == p) { close(fd); return false; }
+			madvise(p, Size, MADV_SEQUENTIAL); // pages are read once from start to end
+			Data = (const char *)p;
+		}
+		close(fd);
+		return true;
+	}
+
+	~CaptureFile()
+	{
+		if (Data) munmap((void *)Data, Size);
+	}
+};
+
+/* Conversion of capture times to microseconds: us = time * Mul / Div.         */
+struct TimeScale
+{
+	uint64_t Mul = 1, Div = 1;
+
+	/* Parses a unit name (s, ms, us, ns, ps). Returns false if it is unknown. */
+	bool SetUnit(const char *unit)
+	{
+		Mul = 1; Div = 1;
+		if (!strcmp(unit, "s")) Mul = 1000000;
+		else if (!strcmp(unit, "ms")) Mul = 1000;
+		else if (!strcmp(unit, "us")) ;
+		else if (!strcmp(unit, "ns")) Div = 1000;
+		else if (!strcmp(unit, "ps")) Div = 1000000;
+		else return false;
+		return true;
+	}
+
+	void Scale(uint64_t n)
+	{
+		Mul *= n;
+		while ((Mul % 10 == 0) && (Div % 10 == 0)) { Mul /= 10; Div /= 10; }
+	}
+
+	uint64_t ToMicroseconds(uint64_t time) const
+	{
+		if (1 == Div) return time * Mul;
+		if (1000 == Div) return time * Mul / 1000; // constant division of the common ns case
+		return time * Mul / Div;
+	}
+};
+
+/* Decoder of one signal. It emulates the timer of the firmware: the counter is
+   reset on each signal change, started by the decoder and stopped by the
+   overflow interrupt after 65535 microseconds.                                */
+struct EdgeDecoder
+{
+	ASKRmt_DecoderState State = ASKRmt_DECODERSTATE_INIT(0);
+	ASKRmt_Combiner Combiner = {};
+	uint8_t  Data[ASKRmt_DATA_SIZE] = {};
+	uint8_t  Level = 0xFF; // unknown
+	bool     TimerRunning = false;
+	uint64_t TimerBase = 0; // time of the last counter reset
+	uint64_t Edges = 0;
+
+	/* Enables soft combining. The decoder must not be copied after it.        */
+	void EnableCombining()
+	{
+		State.Combiner = &Combiner;
+	}
+
+	/* Decodes a signal change. Returns true if a frame is received into Data. */
+	inline bool Edge(uint64_t time, uint8_t level)
+	{
+		if (level == Level) return false; // only changes of the pin raise the interrupt
+		Level = level;
+		Edges++;
+		uint16_t tim = 0; // the stopped timer is always at 0
+		if (TimerRunning)
+		{
+			if (time - TimerBase > 0xFFFF) // overflow interrupt
+			{
+				TimerRunning = false;
+				ASKRmt_ResetDecoder(&State);
+			}
+			else
+				tim = (uint16_t)(time - TimerBase);
+		}
+		TimerBase = time;
+		uint8_t r = ASKRmt_DecodeEdge(&State, Data, level, tim);
+		if (r & ASKRmt_EDGE_STARTTIMER) TimerRunning = true;
+		return (r & ASKRmt_EDGE_FRAME);
+	}
+};
+
+/* Reads the signal change number "i" of a raw capture.                        */
+static inline void ReadRawEdge(const char *data, size_t i, const TimeScale &scale, uint64_t &time, uint8_t &level)
+{
+	uint64_t w;
+	memcpy(&w, data + i * 8, 8);
+	time = scale.ToMicroseconds(w & 0x7FFFFFFFFFFFFFFFULL);
+	level = (uint8_t)(w >> 63);
+}
+
+/* Streams the signal changes of a raw capture to "sink(timeUs, level)".       */
+template <typename Sink>
+void ReadRawCapture(const char *data, size_t size, const TimeScale &scale, Sink &sink)
+{
+	size_t count = size / 8;
+	const char *p = data;
+	if ((1 == scale.Mul) && (1 == scale.Div))
+		for (size_t i = 0; i < count; i++, p += 8)
+		{
+			uint64_t w;
+			memcpy(&w, p, 8);
+			sink(w & 0x7FFFFFFFFFFFFFFFULL, (uint8_t)(w >> 63));
+		}
+	else
+		for (size_t i = 0; i < count; i++, p += 8)
+		{
+			uint64_t w;
+			memcpy(&w, p, 8);
+			sink(scale.ToMicroseconds(w & 0x7FFFFFFFFFFFFFFFULL), (uint8_t)(w >> 63));
+		}
+}
+
+/* Streams the signal changes of a CSV capture. "column" is the zero-based
+   column of the pin value and "unitUs" is the length of one time unit in
+   microseconds. Only the rows where the value changes are passed to the sink.
+   The capture is not terminated, so the time is parsed from a copy of its
+   field and a row with a time of more than 63 characters is skipped.          */
+template <typename Sink>
+void ReadCsvCapture(const char *data, size_t size, unsigned column, double unitUs, Sink &sink)
+{
+	const char *p = data, *end = data + size;
+	int level = -1;
+	while (p < end)
+	{
+		const char *eol = (const char *)memchr(p, '\n', end - p);
+		if (!eol) eol = end;
+		if ((*p >= '0' && *p <= '9') || *p == '.' || *p == '-' || *p == '+')
+		{
+			char buf[64];
+			size_t n = 0;
+			while (p + n < eol && p[n] != ',' && n < sizeof(buf) - 1) { buf[n] = p[n]; n++; }
+			buf[n] = 0;
+			char *q;
+			double t = strtod(buf, &q);
+			const char *c = p + (q - buf);
+			bool valid = ((p + n == eol) || (p[n] == ',')) && (c <= eol); // the whole time is copied
+			for (unsigned col = 0; valid && col < column && c < eol; col++)
+			{
+				c = (const char *)memchr(c, ',', eol - c);
+				if (!c) break;
+				c++;
+			}
+			if (valid && c && c < eol)
+			{
+				while (c < eol && (*c == ' ' || *c == '\t')) c++;
+				int v = (c < eol && *c != '0') ? 1 : 0;
+				if (v != level)
+				{
+					level = v;
+					sink((uint64_t)(t * unitUs + 0.5), (uint8_t)v);
+				}
+			}
+		}
+		p = eol + 1;
+	}
+}
+
+/* Value Change Dump reader.                                                   */
+struct VcdReader
+{
+	const char *Signal = 0; // variable name to decode, 0 selects the first 1-bit variable
+	char        Id[32] = "";
+	TimeScale   Scale;
+
+	/* Returns the next whitespace separated token or 0 at the end.            */
+	static const char *Token(const char *&p, const char *end, size_t &len)
+	{
+		while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+		if (p >= end) return 0;
+		const char *t = p;
+		while (p < end && !(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+		len = p - t;
+		return t;
+	}
+
+	static bool TokenIs(const char *t, size_t len, const char *s)
+	{
+		return (strlen(s) == len) && !memcmp(t, s, len);
+	}
+
+	/* Parses the header. Returns the start of the value changes or 0 if the
+	   signal is not found.                                                    */
+	const char *ParseHeader(const char *p, const char *end)
+	{
+		size_t len;
+		const char *t;
+		Scale.Mul = 1; Scale.Div = 1000; // default 1ns
+		while ((t = Token(p, end, len)))
+		{
+			if (TokenIs(t, len, "$timescale"))
+			{
+				char buf[32] = "";
+				size_t n = 0;
+				while ((t = Token(p, end, len)) && !TokenIs(t, len, "$end"))
+					for (size_t i = 0; i < len && n < sizeof(buf) - 1; i++) buf[n++] = t[i];
+				buf[n] = 0;
+				char *unit;
+				unsigned long m = strtoul(buf, &unit, 10);
+				if (!Scale.SetUnit(unit)) return 0;
+				Scale.Scale(m ? m : 1);
+			}
+			else if (TokenIs(t, len, "$var"))
+			{
+				const char *f[4];
+				size_t fl[4];
+				int n = 0;
+				while ((t = Token(p, end, len)) && !TokenIs(t, len, "$end"))
+					if (n < 4) { f[n] = t; fl[n] = len; n++; }
+				// $var type size id name $end
+				if (n == 4 && !Id[0] && TokenIs(f[1], fl[1], "1") && fl[2] < sizeof(Id) &&
+					(!Signal || TokenIs(f[3], fl[3], Signal)))
+				{
+					memcpy(Id, f[2], fl[2]);
+					Id[fl[2]] = 0;
+				}
+			}
+			else if (TokenIs(t, len, "$enddefinitions"))
+			{
+				while ((t = Token(p, end, len)) && !TokenIs(t, len, "$end")) ;
+				return Id[0] ? p : 0;
+			}
+		}
+		return 0;
+	}
+
+	/* Streams the changes of the selected signal to the sink.                 */
+	template <typename Sink>
+	void ReadChanges(const char *p, const char *end, Sink &sink)
+	{
+		size_t idLen = strlen(Id), len;
+		const char *t;
+		uint64_t time = 0;
+		int level = -1;
+		while ((t = Token(p, end, len)))
+		{
+			char c = t[0];
+			if ('#' == c)
+			{
+				uint64_t v = 0;
+				for (size_t i = 1; i < len && t[i] >= '0' && t[i] <= '9'; i++) v = v * 10 + (t[i] - '0');
+				time = Scale.ToMicroseconds(v);
+			}
+			else if ('b' == c || 'B' == c || 'r' == c || 'R' == c)
+			{
+				// vector value: "b<value> <id>"
+				char lsb = t[len - 1];
+				const char *id = Token(p, end, len);
+				if (id && len == idLen && !memcmp(id, Id, len))
+				{
+					int v = ('1' == lsb) ? 1 : 0; // only the least significant bit is used
+					if (v != level) { level = v; sink(time, (uint8_t)v); }
+				}
+			}
+			else if ('$' == c)
+			{
+				// skip $comment ... $end blocks, other keywords have no body here
+				if (TokenIs(t, len, "$comment"))
+					while ((t = Token(p, end, len)) && !TokenIs(t, len, "$end")) ;
+			}
+			else if (len == idLen + 1 && !memcmp(t + 1, Id, idLen))
+			{
+				int v = ('1' == c) ? 1 : 0; // x and z are read as 0
+				if (v != level) { level = v; sink(time, (uint8_t)v); }
+			}
+		}
+	}
+};
+
+#endif /* ASKRmtCapture_H_ */
@@ -0,0 +1,481 @@
+/*
+ * ASKRmtCaptureDecoder.cpp
+ *  Offline decoder of ASK RF remote control signal captures. It streams a memory-mapped capture file through the
+ *  decoder state machine of the firmware (ASKRemoteControlCore.h) with the same 1MHz timer behavior and writes the
+ *  decoded frames with their times as "time_us,code" lines.
+ *  Raw captures can be decoded by several threads. The capture is split into one chunk per thread and each thread
+ *  decodes its chunk from the idle state, so it locks on the first preamble (1:31) of the chunk. Then the decoder of
+ *  the previous chunk continues across the boundary until its state matches the state of the chunk decoder. The
+ *  frames that straddle the boundary are taken from the previous chunk and the rest from the chunk decoder, so the
+ *  output is the same as the output of one thread.
+ *  With -p the signal changes are decoded in blocks of pulses by the batch classifier of ASKRmtPulses.h.
+ *  Build it with -DASKRmt_ADAPTIVETIMING to decode with the adaptive pulse timing of the default firmware
+ *  configuration. The batch classifier checks the pulse ratios, so -p is not available then.
+ *
+ *  Usage: ASKRmtCaptureDecoder [-f raw|csv|vcd] [-u unit] [-c column] [-s signal] [-j threads] [-b] [-p] [-o output]
+ *         [-v] capture
+ *   -f  capture format. By default it is selected by the file extension (.csv, .vcd, others are raw).
+ *   -u  time unit of raw and csv captures: s, ms, us, ns or ps. The default is us for raw and s for csv.
+ *   -c  zero-based column of the pin value in csv captures. The default is 1.
+ *   -s  name of the vcd variable to decode. The default is the first 1-bit variable.
+ *   -j  number of decoding threads for raw captures. 0 uses all processors. The default is 1.
+ *   -b  benchmark: decode a raw capture with 1, 2, 4, ... threads up to -j (all processors by default), check that
+ *       the frames are the same as the frames of the sequential decoding and print the speed of each run.
+ *   -p  decode with the SIMD batch pulse classifier (one thread).
+ *   -o  output file. The default is the standard output.
+ *   -v  print the number of edges and frames and the decoding speed to the standard error.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <time.h>
+#include <getopt.h>
+#include <strings.h>
+#include <thread>
+#include <vector>
+#include "ASKRmtCapture.h"
+#include "ASKRmtPulses.h"
+
+/* Number of signal changes that a chunk decoder records its states for. If the
+   decoder of the previous chunk does not match any of them, it decodes the
+   whole chunk instead.                                                        */
+#define RESYNC_EDGES 65536
+
+/* Smallest number of signal changes of a chunk.                               */
+#define MIN_CHUNK_EDGES (4 * RESYNC_EDGES)
+
+/* Buffered writer of the "time_us,code" output lines.                         */
+struct FrameWriter
+{
+	FILE    *File;
+	char     Buffer[1 << 16];
+	size_t   Used = 0;
+
+	void Flush()
+	{
+		fwrite(Buffer, 1, Used, File);
+		Used = 0;
+	}
+
+	void Frame(uint64_t time, const uint8_t *data)
+	{
+		static const char hex[] = "0123456789ABCDEF";
+		if (Used > sizeof(Buffer) - 64) Flush();
+		char digits[20];
+		int n = 0;
+		do { digits[n++] = '0' + time % 10; time /= 10; } while (time);
+		char *p = Buffer + Used;
+		while (n) *p++ = digits[--n];
+		*p++ = ',';
+		for (int i = 0; i < ASKRmt_DATA_SIZE; i++)
+		{
+			*p++ = hex[data[i] >> 4];
+			*p++ = hex[data[i] & 0xF];
+		}
+		*p++ = '\n';
+		Used = p - Buffer;
+	}
+};
+
+/* Sequential decoder sink of the capture readers.                            */
+struct CaptureDecoder
+{
+	EdgeDecoder  Decoder;
+	uint64_t     Frames = 0;
+	FrameWriter *Output;
+
+	inline void operator()(uint64_t time, uint8_t level)
+	{
+		if (Decoder.Edge(time, level))
+		{
+			Frames++;
+			Output->Frame(time, Decoder.Data);
+		}
+	}
+};
+
+/* Sequential decoder sink that decodes the signal changes in blocks of pulses. */
+struct BatchCaptureDecoder
+{
+	PulseExtractor  Extractor;
+	SymbolDecoder   Symbols;
+	PulseClassifier Classify = GetPulseClassifier(0);
+	PulseBlock      Block;
+	uint64_t        Frames = 0;
+	FrameWriter    *Output;
+
+	inline void operator()(uint64_t time, uint8_t level)
+	{
+		if (Extractor.Edge(time, level, Block) && (PULSE_BLOCK == Block.Count)) Flush();
+	}
+
+	/* Decodes the pulses of the block. Call it after the last signal change.  */
+	void Flush()
+	{
+		Classify(Block.High, Block.Low, Block.Symbol, Block.Count);
+		auto sink = [this](uint64_t time, const uint8_t *data) { Frames++; Output->Frame(time, data); };
+		Symbols.Decode(Block, sink);
+		Block.Count = 0;
+	}
+};
+
+/* Frame decoded from a raw capture. Index is the number of the signal change
+   that completed it.                                                          */
+struct DecodedFrame
+{
+	size_t   Index;
+	uint64_t Time;
+	uint8_t  Code[ASKRmt_DATA_SIZE];
+
+	DecodedFrame(size_t index, uint64_t time, const uint8_t *data) : Index(index), Time(time)
+	{
+		memcpy(Code, data, ASKRmt_DATA_SIZE);
+	}
+};
+
+/* Part of the decoder state that the following frames depend on. Level and
+   TimerBase are not included since they only depend on the previous signal
+   changes.                                                                    */
+struct DecoderSnapshot
+{
+	uint8_t  BitIndex;
+	bool     TimerRunning;
+	uint16_t FirstTime;
+	ASKRmt_Code Code;
+	#ifdef ASKRmt_ADAPTIVETIMING
+	uint16_t LongMin; // the other bounds are computed from the same short pulse length
+	#endif
+
+	inline void Take(const EdgeDecoder &d)
+	{
+		BitIndex = d.State.BitIndex;
+		TimerRunning = d.TimerRunning;
+		FirstTime = d.State.FirstTime;
+		Code = d.State.Code;
+		#ifdef ASKRmt_ADAPTIVETIMING
+		LongMin = d.State.LongMin;
+		#endif
+	}
+
+	inline bool Matches(const EdgeDecoder &d) const
+	{
+		if ((BitIndex != d.State.BitIndex) || (TimerRunning != d.TimerRunning) || (FirstTime != d.State.FirstTime)) return false;
+		if (24 <= BitIndex) return true; // received bits and bounds matter only in a frame
+		#ifdef ASKRmt_ADAPTIVETIMING
+		if (LongMin != d.State.LongMin) return false;
+		#endif
+		return (Code == d.State.Code);
+	}
+};
+
+/* Signal changes [Start, End) of a raw capture and their decoding.            */
+struct CaptureChunk
+{
+	size_t                       Start, End;
+	EdgeDecoder                  Decoder;
+	std::vector<DecodedFrame>    Frames;
+	std::vector<DecoderSnapshot> States; // state after each of the first RESYNC_EDGES changes
+};
+
+/* Decodes signal changes [from, to) of a raw capture and appends the frames.  */
+static void DecodeRawEdges(const char *data, const TimeScale &scale, EdgeDecoder &d, size_t from, size_t to, std::vector<DecodedFrame> &frames)
+{
+	for (size_t i = from; i < to; i++)
+	{
+		uint64_t time;
+		uint8_t level;
+		ReadRawEdge(data, i, scale, time, level);
+		if (d.Edge(time, level)) frames.push_back({ i, time, d.Data });
+	}
+}
+
+/* Decodes a chunk from the idle state. The pin value before the chunk is taken
+   from the previous signal change, so only the decoder state is unknown.     */
+static void DecodeChunk(const char *data, const TimeScale &scale, CaptureChunk *c)
+{
+	EdgeDecoder &d = c->Decoder;
+	if (c->Start)
+	{
+		uint64_t time;
+		ReadRawEdge(data, c->Start - 1, scale, time, d.Level);
+	}
+	size_t logged = c->End - c->Start;
+	if (logged > RESYNC_EDGES) logged = RESYNC_EDGES;
+	c->States.resize(logged);
+	for (size_t i = c->Start; i < c->Start + logged; i++)
+	{
+		DecodeRawEdges(data, scale, d, i, i + 1, c->Frames);
+		c->States[i - c->Start].Take(d);
+	}
+	DecodeRawEdges(data, scale, d, c->Start + logged, c->End, c->Frames);
+}
+
+/* Decodes a raw capture with "threads" threads. The frames and the number of
+   signal changes are the same as the sequential decoding.                     */
+static void DecodeRawParallel(const char *data, size_t size, const TimeScale &scale, unsigned threads, std::vector<DecodedFrame> &frames, uint64_t &edges)
+{
+	size_t count = size / 8;
+	if (threads > count / MIN_CHUNK_EDGES) threads = count / MIN_CHUNK_EDGES;
+	if (!threads) threads = 1;
+	std::vector<CaptureChunk> chunks(threads);
+	for (unsigned k = 0; k < threads; k++)
+	{
+		chunks[k].Start = count * k / threads;
+		chunks[k].End = count * (k + 1) / threads;
+	}
+	std::vector<std::thread> workers;
+	for (unsigned k = 1; k < threads; k++) workers.emplace_back(DecodeChunk, data, std::cref(scale), &chunks[k]);
+	DecodeChunk(data, scale, &chunks[0]);
+	for (std::thread &w : workers) w.join();
+
+	// join the chunks in order: "d" is the exact decoder state at the start of chunk k
+	frames.clear();
+	edges = 0;
+	EdgeDecoder d;
+	for (unsigned k = 0; k < threads; k++)
+	{
+		CaptureChunk &c = chunks[k];
+		edges += c.Decoder.Edges; // the pin value before the chunk is exact, so the changes are counted exactly
+		size_t next = c.Start; // first signal change that the frames of the chunk decoder are taken from
+		if (k)
+		{
+			next = c.End;
+			for (size_t i = c.Start; i < c.Start + c.States.size(); i++)
+			{
+				DecodeRawEdges(data, scale, d, i, i + 1, frames);
+				if (c.States[i - c.Start].Matches(d)) { next = i + 1; break; }
+			}
+			if (c.End == next) // no match, decode the rest of the chunk here
+			{
+				DecodeRawEdges(data, scale, d, c.Start + c.States.size(), c.End, frames);
+				continue;
+			}
+		}
+		for (const DecodedFrame &f : c.Frames)
+			if (f.Index >= next) frames.push_back(f);
+		d = c.Decoder;
+	}
+}
+
+/* Collects the frames of the sequential decoding for the benchmark.           */
+struct FrameCollector
+{
+	EdgeDecoder                Decoder;
+	std::vector<DecodedFrame> *Frames;
+	size_t                     Index = 0;
+
+	inline void operator()(uint64_t time, uint8_t level)
+	{
+		if (Decoder.Edge(time, level)) Frames->push_back({ Index, time, Decoder.Data });
+		Index++;
+	}
+};
+
+static double Seconds(const struct timespec &t0, const struct timespec &t1)
+{
+	return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+}
+
+static bool SameFrames(const std::vector<DecodedFrame> &a, const std::vector<DecodedFrame> &b)
+{
+	if (a.size() != b.size()) return false;
+	for (size_t i = 0; i < a.size(); i++)
+		if ((a[i].Time != b[i].Time) || memcmp(a[i].Code, b[i].Code, ASKRmt_DATA_SIZE)) return false;
+	return true;
+}
+
+/* Decodes a raw capture sequentially and with 1, 2, 4, ... threads and prints
+   the speed of each run. Returns false if a run has different frames.         */
+static bool Benchmark(const char *data, size_t size, const TimeScale &scale, unsigned maxThreads)
+{
+	struct timespec t0, t1;
+	std::vector<DecodedFrame> reference, frames;
+	FrameCollector collector;
+	collector.Frames = &reference;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	ReadRawCapture(data, size, scale, collector);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	double s1 = Seconds(t0, t1);
+	uint64_t edges = collector.Decoder.Edges;
+	printf("%llu edges, %llu frames, %u processors\n", (unsigned long long)edges, (unsigned long long)reference.size(), std::thread::hardware_concurrency());
+	printf("threads  seconds  M edges/s  speedup  frames\n");
+	printf("%-7s  %7.3f  %9.1f  %7.2f  reference\n", "seq", s1, s1 > 0 ? edges / s1 * 1e-6 : 0.0, 1.0);
+	bool ok = true;
+	for (unsigned t = 1; t <= maxThreads; t = (t * 2 > maxThreads && t < maxThreads) ? maxThreads : t * 2)
+	{
+		uint64_t n;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		DecodeRawParallel(data, size, scale, t, frames, n);
+		clock_gettime(CLOCK_MONOTONIC, &t1);
+		double s = Seconds(t0, t1);
+		bool same = (n == edges) && SameFrames(reference, frames);
+		ok = ok && same;
+		printf("%-7u  %7.3f  %9.1f  %7.2f  %s\n", t, s, s > 0 ? n / s * 1e-6 : 0.0, s > 0 ? s1 / s : 0.0, same ? "identical" : "DIFFERENT");
+	}
+	return ok;
+}
+
+/* Streams the signal changes of a capture to the sink. Returns false if the
+   signal is not found in a VCD capture.                                       */
+template <typename Sink>
+static bool ReadCapture(const CaptureFile &capture, CaptureFormat fmt, const TimeScale &scale, unsigned column, const char *signal, Sink &sink)
+{
+	if (CAPTURE_RAW == fmt)
+		ReadRawCapture(capture.Data, capture.Size, scale, sink);
+	else if (CAPTURE_CSV == fmt)
+		ReadCsvCapture(capture.Data, capture.Size, column, (double)scale.Mul / scale.Div, sink);
+	else
+	{
+		VcdReader vcd;
+		vcd.Signal = signal;
+		const char *changes = vcd.ParseHeader(capture.Data, capture.Data + capture.Size);
+		if (!changes) return false;
+		vcd.ReadChanges(changes, capture.Data + capture.Size, sink);
+	}
+	return true;
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "Usage: ASKRmtCaptureDecoder [-f raw|csv|vcd] [-u unit] [-c column] [-s signal] [-j threads] [-b] [-p] [-o output] [-v] capture\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *format = 0, *unit = 0, *signal = 0, *output = 0;
+	unsigned column = 1, threads = 1;
+	bool verbose = false, benchmark = false, threadsSet = false, batch = false;
+	int opt;
+	while ((opt = getopt(argc, argv, "f:u:c:s:j:bpo:v")) != -1)
+	{
+		switch (opt)
+		{
+			case 'f': format = optarg; break;
+			case 'u': unit = optarg; break;
+			case 'c': column = strtoul(optarg, 0, 10); break;
+			case 's': signal = optarg; break;
+			case 'j': threads = strtoul(optarg, 0, 10); threadsSet = true; break;
+			case 'b': benchmark = true; break;
+			case 'p': batch = true; break;
+			case 'o': output = optarg; break;
+			case 'v': verbose = true; break;
+			default: Usage(); return 2;
+		}
+	}
+	if (optind + 1 != argc) { Usage(); return 2; }
+	const char *path = argv[optind];
+
+	CaptureFormat fmt = CAPTURE_RAW;
+	if (!format)
+	{
+		const char *ext = strrchr(path, '.');
+		if (ext && !strcasecmp(ext, ".csv")) fmt = CAPTURE_CSV;
+		if (ext && !strcasecmp(ext, ".vcd")) fmt = CAPTURE_VCD;
+	}
+	else if (!strcmp(format, "csv")) fmt = CAPTURE_CSV;
+	else if (!strcmp(format, "vcd")) fmt = CAPTURE_VCD;
+	else if (strcmp(format, "raw")) { Usage(); return 2; }
+
+	TimeScale scale;
+	if (!scale.SetUnit(unit ? unit : (CAPTURE_CSV == fmt ? "s" : "us")))
+	{
+		fprintf(stderr, "Unknown time unit: %s\n", unit);
+		return 2;
+	}
+
+	if (!threads || (benchmark && !threadsSet)) threads = std::thread::hardware_concurrency();
+	if (!threads) threads = 1;
+	if ((threads > 1 || benchmark) && CAPTURE_RAW != fmt)
+	{
+		fprintf(stderr, "Only raw captures can be decoded by several threads.\n");
+		return 2;
+	}
+	if (batch && (threads > 1 || benchmark))
+	{
+		fprintf(stderr, "The batch decoding uses one thread.\n");
+		return 2;
+	}
+	#ifdef ASKRmt_ADAPTIVETIMING
+	if (batch)
+	{
+		fprintf(stderr, "The batch decoding checks the pulse ratios. Build without ASKRmt_ADAPTIVETIMING to use it.\n");
+		return 2;
+	}
+	#endif
+
+	CaptureFile capture;
+	if (!capture.Open(path))
+	{
+		fprintf(stderr, "Can not open the capture file: %s\n", path);
+		return 1;
+	}
+	if (benchmark) return Benchmark(capture.Data, capture.Size, scale, threads) ? 0 : 1;
+
+	static FrameWriter writer;
+	writer.File = output ? fopen(output, "w") : stdout;
+	if (!writer.File)
+	{
+		fprintf(stderr, "Can not create the output file: %s\n", output);
+		return 1;
+	}
+	fputs("time_us,code\n", writer.File);
+
+	struct timespec t0, t1;
+	uint64_t edges, frames;
+	bool found = true;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	if (threads > 1)
+	{
+		std::vector<DecodedFrame> decoded;
+		DecodeRawParallel(capture.Data, capture.Size, scale, threads, decoded, edges);
+		for (const DecodedFrame &f : decoded) writer.Frame(f.Time, f.Code);
+		frames = decoded.size();
+	}
+	else if (batch)
+	{
+		static BatchCaptureDecoder decoder;
+		decoder.Output = &writer;
+		found = ReadCapture(capture, fmt, scale, column, signal, decoder);
+		decoder.Flush();
+		edges = decoder.Extractor.Edges;
+		frames = decoder.Frames;
+	}
+	else
+	{
+		CaptureDecoder decoder;
+		decoder.Output = &writer;
+		found = ReadCapture(capture, fmt, scale, column, signal, decoder);
+		edges = decoder.Decoder.Edges;
+		frames = decoder.Frames;
+	}
+	if (!found)
+	{
+		fprintf(stderr, "No 1-bit signal%s%s is found in the VCD header.\n", signal ? " " : "", signal ? signal : "");
+		return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	writer.Flush();
+	bool ok = !ferror(writer.File);
+	if (output && fclose(writer.File)) ok = false;
+	if (!ok)
+	{
+		fprintf(stderr, "Can not write the output.\n");
+		return 1;
+	}
+
+	if (verbose)
+	{
+		double s = Seconds(t0, t1);
+		fprintf(stderr, "%llu edges, %llu frames, %u threads, %.3f s, %.1f M edges/s\n",
+			(unsigned long long)edges, (unsigned long long)frames, threads, s, s > 0 ? edges / s * 1e-6 : 0.0);
+	}
+	return 0;
+}
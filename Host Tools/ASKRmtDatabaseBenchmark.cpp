@@ -0,0 +1,174 @@
+/*
+ * ASKRmtDatabaseBenchmark.cpp
+ *  Lookup latency benchmark of the sorted store of ASKRemoteControlDatabase.h. For each population from 16 remote
+ *  controls to the given number, doubling, it saves random remote controls to an emulated storage, looks up saved and
+ *  unsaved remote controls and reports the block reads and the bytes read per lookup, the host time per lookup and
+ *  the estimated time of the reads on an I2C EEPROM. The same lookups are counted for the linear scan of 3-byte slots
+ *  of the fixed slots store without the index.
+ *
+ *  Usage: ASKRmtDatabaseBenchmark [-n population] [-q lookups] [-s size] [-k clock] [-x seed]
+ *   -n  largest population. The default is 4096.
+ *   -q  lookups per population, half of them saved. The default is 20000.
+ *   -s  storage size in bytes. The default is 65534 (a 24C512).
+ *   -k  I2C clock in kHz for the time estimates. The default is 400.
+ *   -x  random seed. The default is 1.
+ *  Build with -DASKRmt_SORTEDSTORE_LEAFRECORDS=n to measure other leaf sizes.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <vector>
+#include "../ASK Remote Control Decoder/ASKRemoteControlDatabase.h"
+#include "ASKRmtSignalGenerator.h"
+
+/* Emulated storage and its access counters.                                   */
+static uint8_t  Storage[65536];
+static uint64_t Reads, ReadBytes, WrittenBytes;
+
+static void StorageReadBlock(uint16_t addr, void *dst, uint16_t n)
+{
+	memcpy(dst, &Storage[addr], n);
+	Reads++;
+	ReadBytes += n;
+}
+
+static void StorageWriteBlock(uint16_t addr, const void *src, uint16_t n)
+{
+	memcpy(&Storage[addr], src, n);
+	WrittenBytes += n;
+}
+
+/* Matches remote controls like the decoder: FixCode remote controls by the
+   address and LearningCode remote controls also by the most significant
+   nibble of the 3rd byte.                                                     */
+static bool IsRemoteMatch(const uint8_t *code, const uint8_t *data)
+{
+	if (code[2] & 1) return true;
+	return ((code[2] & 0xF0) == (data[2] & 0xF0));
+}
+
+/* Time of a random read of "n" bytes of an I2C EEPROM in microseconds: start,
+   device address, 2 address bytes, repeated start, device address, the data
+   and stop, 9 clocks per byte.                                                */
+static double I2CReadMicroseconds(uint64_t reads, uint64_t bytes, double kHz)
+{
+	return (reads * (4 * 9 + 3) + bytes * 9) * 1000.0 / kHz;
+}
+
+static double CpuSeconds(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "Usage: ASKRmtDatabaseBenchmark [-n population] [-q lookups] [-s size] [-k clock] [-x seed]\n");
+}
+
+int main(int argc, char **argv)
+{
+	unsigned population = 4096, lookups = 20000, size = 65534;
+	double kHz = 400;
+	uint64_t seed = 1;
+	int opt;
+	while ((opt = getopt(argc, argv, "n:q:s:k:x:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': population = strtoul(optarg, 0, 10); break;
+			case 'q': lookups = strtoul(optarg, 0, 10); break;
+			case 's': size = strtoul(optarg, 0, 10); break;
+			case 'k': kHz = strtod(optarg, 0); break;
+			case 'x': seed = strtoull(optarg, 0, 10); break;
+			default: Usage(); return 2;
+		}
+	}
+	if (!lookups || (size < 2) || (size > 65535) || (kHz <= 0)) { Usage(); return 2; }
+
+	printf("%u-code leaves, %u bytes storage (%u leaves), %u lookups per population, %.0f kHz I2C\n",
+		ASKRmt_SORTEDSTORE_LEAFRECORDS, size, (unsigned)ASKRmt_DB_LEAVES(size), lookups, kHz);
+	printf("  codes  leaves  written/save  reads/lookup  max reads  bytes/lookup  ns/lookup  I2C us/lookup  scan reads  scan I2C us\n");
+	for (unsigned n = 16; n <= population; n *= 2)
+	{
+		SignalRandom random = { seed };
+		memset(Storage, 0xFF, sizeof(Storage));
+		ASKRmt_Database db = { 0, (uint16_t)ASKRmt_DB_LEAVES(size), 0, StorageReadBlock, StorageWriteBlock };
+		ASKRmt_DBOpen(&db);
+
+		// random remote controls with different addresses, in the order they are saved
+		std::vector<uint8_t> saved(65536, 0);
+		std::vector<uint32_t> codes;
+		WrittenBytes = 0;
+		while (codes.size() < n)
+		{
+			uint32_t code = (uint32_t)random.Next() & 0xFFFFF1;
+			if (saved[code >> 8]) continue;
+			uint8_t bytes[3] = { (uint8_t)(code >> 16), (uint8_t)(code >> 8), (uint8_t)code };
+			if (!ASKRmt_DBInsert(&db, bytes)) break;
+			saved[code >> 8] = 1;
+			codes.push_back(code);
+		}
+		if (codes.size() < n)
+		{
+			printf("%7u  the storage is full after %zu codes\n", n, codes.size());
+			break;
+		}
+		double writtenPerSave = (double)WrittenBytes / n;
+
+		// half of the lookups are saved remote controls, the others are not saved
+		std::vector<uint32_t> queries(lookups);
+		for (unsigned i = 0; i < lookups; i++)
+		{
+			uint32_t code;
+			if (i & 1)
+				code = codes[random.Next() % n];
+			else
+				do code = (uint32_t)random.Next() & 0xFFFFF1; while (saved[code >> 8]);
+			queries[i] = code;
+		}
+
+		uint64_t maxReads = 0, found = 0, scanReads = 0, scanBytes = 0;
+		Reads = ReadBytes = 0;
+		double t0 = CpuSeconds();
+		for (uint32_t code : queries)
+		{
+			uint64_t before = Reads;
+			uint8_t bytes[3] = { (uint8_t)(code >> 16), (uint8_t)(code >> 8), (uint8_t)code }, match[3];
+			if (ASKRmt_DB_NONE != ASKRmt_DBFind(&db, bytes, 2, IsRemoteMatch, match)) found++;
+			if (Reads - before > maxReads) maxReads = Reads - before;
+		}
+		double seconds = CpuSeconds() - t0;
+		if (found != lookups / 2) printf("%7u  %llu saved codes are found instead of %u\n", n, (unsigned long long)found, lookups / 2);
+		uint64_t reads = Reads, bytesRead = ReadBytes;
+
+		// the scan reads the slots in the order they are saved until the code is found
+		std::vector<uint32_t> position(65536, 0);
+		for (unsigned i = 0; i < n; i++) position[codes[i] >> 8] = i + 1;
+		for (uint32_t code : queries)
+		{
+			uint32_t p = position[code >> 8];
+			scanReads += p ? p : n;
+		}
+		scanBytes = scanReads * 3;
+
+		printf("%7u  %6u  %12.1f  %12.2f  %9llu  %12.1f  %9.1f  %13.0f  %10.1f  %11.0f\n", n, db.Used, writtenPerSave,
+			(double)reads / lookups, (unsigned long long)maxReads, (double)bytesRead / lookups, seconds / lookups * 1e9,
+			I2CReadMicroseconds(reads, bytesRead, kHz) / lookups,
+			(double)scanReads / lookups, I2CReadMicroseconds(scanReads, scanBytes, kHz) / lookups);
+	}
+	return 0;
+}
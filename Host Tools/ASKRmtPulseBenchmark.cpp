@@ -0,0 +1,178 @@
+/*
+ * ASKRmtPulseBenchmark.cpp
+ *  Verification and benchmark of the batch pulse classifiers of ASKRmtPulses.h. Each classifier that the processor
+ *  supports is checked against the checks of ASKRmt_DecodeEdge for every (high, low) pair of 16-bit times, then the
+ *  classifiers, the symbols to frames pass and the per-edge state machine are timed in pulses per second.
+ *
+ *  Usage: ASKRmtPulseBenchmark [-s step] [-t seconds]
+ *   -s  check every step-th high time with all low times. The default is 1 (all 2^32 pairs).
+ *   -t  running time of each benchmark in seconds. The default is 0.5.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <getopt.h>
+#include "ASKRmtPulses.h"
+
+#ifdef ASKRmt_ADAPTIVETIMING
+#error "The batch pulse classifiers check the pulse ratios. Build ASKRmtPulseBenchmark without ASKRmt_ADAPTIVETIMING."
+#endif
+
+static const char *ClassifierNames[] = { "scalar", "sse2", "avx2" };
+
+/* Classifies a pulse by running ASKRmt_DecodeEdge on a raise in the bit and
+   preamble states.                                                            */
+static uint8_t ReferenceSymbol(uint16_t high, uint16_t low)
+{
+	uint8_t data[ASKRmt_DATA_SIZE] = {};
+	ASKRmt_DecoderState state = { 0, high, 0, 0, 0 };
+	ASKRmt_DecodeEdge(&state, data, 1, low);
+	if (1 == state.BitIndex) return (state.Code & 1) ? PULSE_ONE : PULSE_ZERO;
+	state.BitIndex = ASKRmt_BITINDEX_PREAMBLE;
+	ASKRmt_DecodeEdge(&state, data, 1, low);
+	return (0 == state.BitIndex) ? PULSE_PREAMBLE : PULSE_INVALID;
+}
+
+static double Now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Checks the classifiers on every step-th high time. Returns false on the
+   first difference.                                                           */
+static bool Verify(unsigned step)
+{
+	static uint16_t high[65536], low[65536];
+	static uint8_t expected[65536], symbols[65536];
+	for (unsigned l = 0; l < 65536; l++) low[l] = l;
+	unsigned long long pairs = 0;
+	for (unsigned h = 0; h < 65536; h += step)
+	{
+		for (unsigned l = 0; l < 65536; l++)
+		{
+			high[l] = h;
+			expected[l] = ReferenceSymbol(h, l);
+		}
+		for (const char *name : ClassifierNames)
+		{
+			PulseClassifier classify = GetPulseClassifier(name);
+			if (!classify) continue;
+			// odd offsets and lengths exercise the unaligned loads and the scalar tail
+			classify(high, low, symbols, 65536);
+			classify(high + 3, low + 3, symbols + 3, 65533 - 7);
+			for (unsigned l = 0; l < 65536; l++)
+				if (symbols[l] != expected[l])
+				{
+					printf("%s: high %u, low %u: symbol %u, expected %u\n", name, h, l, symbols[l], expected[l]);
+					return false;
+				}
+		}
+		pairs += 65536;
+	}
+	printf("%llu pulses checked:", pairs);
+	for (const char *name : ClassifierNames)
+		if (GetPulseClassifier(name)) printf(" %s", name);
+	printf(" are the same as ASKRmt_DecodeEdge\n");
+	return true;
+}
+
+/* Fills a block with frames of random codes and pulse widths and with random
+   noise pulses.                                                               */
+static void MakePulses(PulseBlock &block)
+{
+	srand(1);
+	block.Count = 0;
+	while (block.Count < PULSE_BLOCK)
+	{
+		size_t n = block.Count;
+		if (rand() % 4)
+		{
+			uint16_t t = 250 + rand() % 200;
+			if (rand() % 26) { bool one = rand() % 2; block.High[n] = one ? t * 3 : t; block.Low[n] = one ? t : t * 3; }
+			else { block.High[n] = t; block.Low[n] = t * 31; }
+		}
+		else
+		{
+			block.High[n] = rand() % 65536;
+			block.Low[n] = rand() % 65536;
+		}
+		block.Time[n] = n;
+		block.Reset[n] = 0;
+		block.Count++;
+	}
+}
+
+/* Runs "run" repeatedly on a block for "seconds" and prints the pulses per
+   second.                                                                     */
+template <typename Run>
+static void Measure(const char *name, double seconds, Run run)
+{
+	unsigned long long pulses = 0;
+	double t0 = Now(), t;
+	do
+	{
+		for (int i = 0; i < 64; i++) run();
+		pulses += 64ULL * PULSE_BLOCK;
+		t = Now() - t0;
+	} while (t < seconds);
+	printf("%-24s %9.1f M pulses/s\n", name, pulses / t * 1e-6);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned step = 1;
+	double seconds = 0.5;
+	int opt;
+	while ((opt = getopt(argc, argv, "s:t:")) != -1)
+	{
+		switch (opt)
+		{
+			case 's': step = strtoul(optarg, 0, 10); break;
+			case 't': seconds = strtod(optarg, 0); break;
+			default:
+				fprintf(stderr, "Usage: ASKRmtPulseBenchmark [-s step] [-t seconds]\n");
+				return 2;
+		}
+	}
+	if (!step) step = 1;
+	if (!Verify(step)) return 1;
+
+	static PulseBlock block;
+	MakePulses(block);
+	volatile uint8_t sink = 0;
+	for (const char *name : ClassifierNames)
+	{
+		PulseClassifier classify = GetPulseClassifier(name);
+		if (!classify) continue;
+		char label[32];
+		snprintf(label, sizeof(label), "classify %s", name);
+		Measure(label, seconds, [&]() { classify(block.High, block.Low, block.Symbol, block.Count); sink = sink + block.Symbol[0]; });
+	}
+	SymbolDecoder symbols;
+	volatile unsigned long long frames = 0;
+	auto count = [&](uint64_t, const uint8_t *) { frames = frames + 1; };
+	Measure("symbols to frames", seconds, [&]() { symbols.Decode(block, count); });
+	ASKRmt_DecoderState state = ASKRmt_DECODERSTATE_INIT(0);
+	uint8_t data[ASKRmt_DATA_SIZE];
+	Measure("ASKRmt_DecodeEdge", seconds, [&]()
+	{
+		for (size_t i = 0; i < block.Count; i++)
+		{
+			ASKRmt_DecodeEdge(&state, data, 0, block.High[i]);
+			if (ASKRmt_DecodeEdge(&state, data, 1, block.Low[i]) & ASKRmt_EDGE_FRAME) frames = frames + 1;
+		}
+	});
+	return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * ASKRmtPulses.h
+ *  Batch pulse decoding for the ASK RF remote controls host tools. The signal changes are turned into pulses (the high
+ *  and low times before each raise of the pin), the pulses are classified into 0, 1, preamble and invalid symbols by
+ *  an SSE2 or AVX2 kernel that is selected at runtime, and the symbols are turned into 24-bit frames by a separate
+ *  pass. The result is the same as decoding the signal changes one by one with ASKRemoteControlCore.h.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRmtPulses_H_
+#define ASKRmtPulses_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "../ASK Remote Control Decoder/ASKRemoteControlCore.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PULSES_X86
+#endif
+
+/* Pulse symbols. The checks of ASKRmt_DecodeEdge can not pass together, so a
+   pulse has only one symbol.                                                  */
+#define PULSE_ZERO     0 // LowTime/HighTime~3
+#define PULSE_ONE      1 // HighTime/LowTime~3
+#define PULSE_PREAMBLE 2 // LowTime/HighTime~30
+#define PULSE_INVALID  3
+
+/* Number of pulses of a block.                                                */
+#define PULSE_BLOCK 4096
+
+/* Classifies one pulse with the checks of ASKRmt_DecodeEdge.                  */
+static inline uint8_t ClassifyPulse(uint16_t high, uint16_t low)
+{
+	uint32_t h = high, l = low;
+	if ((h > l * 2) && (h < l * 4)) return PULSE_ONE;
+	if ((l > h * 2) && (l < h * 4)) return PULSE_ZERO;
+	if ((l > h * 27) && (l < h * 33)) return PULSE_PREAMBLE;
+	return PULSE_INVALID;
+}
+
+/* Classifies "count" pulses into symbols.                                     */
+typedef void (*PulseClassifier)(const uint16_t *high, const uint16_t *low, uint8_t *symbols, size_t count);
+
+static void ClassifyPulsesScalar(const uint16_t *high, const uint16_t *low, uint8_t *symbols, size_t count)
+{
+	for (size_t i = 0; i < count; i++) symbols[i] = ClassifyPulse(high[i], low[i]);
+}
+
+#if defined(PULSES_X86)
+
+/* The times are below 2^16 and multiplied by at most 33, so signed 32-bit
+   compares are exact. The symbol is 3 ^ (zero & 3) ^ (one & 2) ^ (preamble & 1)
+   since at most one of the masks is set.                                      */
+__attribute__((target("sse2")))
+static inline __m128i ClassifyPulses4(__m128i h, __m128i l)
+{
+	__m128i h2 = _mm_slli_epi32(h, 1), h4 = _mm_slli_epi32(h, 2), h32 = _mm_slli_epi32(h, 5);
+	__m128i l2 = _mm_slli_epi32(l, 1), l4 = _mm_slli_epi32(l, 2);
+	__m128i h27 = _mm_sub_epi32(_mm_sub_epi32(h32, h4), h), h33 = _mm_add_epi32(h32, h);
+	__m128i one = _mm_and_si128(_mm_cmpgt_epi32(h, l2), _mm_cmpgt_epi32(l4, h));
+	__m128i zero = _mm_and_si128(_mm_cmpgt_epi32(l, h2), _mm_cmpgt_epi32(h4, l));
+	__m128i pre = _mm_and_si128(_mm_cmpgt_epi32(l, h27), _mm_cmpgt_epi32(h33, l));
+	__m128i s = _mm_and_si128(zero, _mm_set1_epi32(3));
+	s = _mm_xor_si128(s, _mm_and_si128(one, _mm_set1_epi32(2)));
+	s = _mm_xor_si128(s, _mm_and_si128(pre, _mm_set1_epi32(1)));
+	return _mm_xor_si128(s, _mm_set1_epi32(3));
+}
+
+__attribute__((target("sse2")))
+static void ClassifyPulsesSSE2(const uint16_t *high, const uint16_t *low, uint8_t *symbols, size_t count)
+{
+	const __m128i z = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i h0 = _mm_loadu_si128((const __m128i *)(high + i)), h1 = _mm_loadu_si128((const __m128i *)(high + i + 8));
+		__m128i l0 = _mm_loadu_si128((const __m128i *)(low + i)), l1 = _mm_loadu_si128((const __m128i *)(low + i + 8));
+		__m128i s0 = ClassifyPulses4(_mm_unpacklo_epi16(h0, z), _mm_unpacklo_epi16(l0, z));
+		__m128i s1 = ClassifyPulses4(_mm_unpackhi_epi16(h0, z), _mm_unpackhi_epi16(l0, z));
+		__m128i s2 = ClassifyPulses4(_mm_unpacklo_epi16(h1, z), _mm_unpacklo_epi16(l1, z));
+		__m128i s3 = ClassifyPulses4(_mm_unpackhi_epi16(h1, z), _mm_unpackhi_epi16(l1, z));
+		__m128i s = _mm_packus_epi16(_mm_packs_epi32(s0, s1), _mm_packs_epi32(s2, s3));
+		_mm_storeu_si128((__m128i *)(symbols + i), s);
+	}
+	ClassifyPulsesScalar(high + i, low + i, symbols + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i ClassifyPulses8(__m256i h, __m256i l)
+{
+	__m256i h2 = _mm256_slli_epi32(h, 1), h4 = _mm256_slli_epi32(h, 2), h32 = _mm256_slli_epi32(h, 5);
+	__m256i l2 = _mm256_slli_epi32(l, 1), l4 = _mm256_slli_epi32(l, 2);
+	__m256i h27 = _mm256_sub_epi32(_mm256_sub_epi32(h32, h4), h), h33 = _mm256_add_epi32(h32, h);
+	__m256i one = _mm256_and_si256(_mm256_cmpgt_epi32(h, l2), _mm256_cmpgt_epi32(l4, h));
+	__m256i zero = _mm256_and_si256(_mm256_cmpgt_epi32(l, h2), _mm256_cmpgt_epi32(h4, l));
+	__m256i pre = _mm256_and_si256(_mm256_cmpgt_epi32(l, h27), _mm256_cmpgt_epi32(h33, l));
+	__m256i s = _mm256_and_si256(zero, _mm256_set1_epi32(3));
+	s = _mm256_xor_si256(s, _mm256_and_si256(one, _mm256_set1_epi32(2)));
+	s = _mm256_xor_si256(s, _mm256_and_si256(pre, _mm256_set1_epi32(1)));
+	return _mm256_xor_si256(s, _mm256_set1_epi32(3));
+}
+
+__attribute__((target("avx2")))
+static void ClassifyPulsesAVX2(const uint16_t *high, const uint16_t *low, uint8_t *symbols, size_t count)
+{
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m256i h = _mm256_loadu_si256((const __m256i *)(high + i)), l = _mm256_loadu_si256((const __m256i *)(low + i));
+		__m256i s0 = ClassifyPulses8(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(h)), _mm256_cvtepu16_epi32(_mm256_castsi256_si128(l)));
+		__m256i s1 = ClassifyPulses8(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(h, 1)), _mm256_cvtepu16_epi32(_mm256_extracti128_si256(l, 1)));
+		__m256i s = _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), 0xD8); // 16-bit symbols in order
+		s = _mm256_packus_epi16(s, s);
+		_mm_storeu_si128((__m128i *)(symbols + i), _mm256_castsi256_si128(_mm256_permute4x64_epi64(s, 0x08)));
+	}
+	ClassifyPulsesScalar(high + i, low + i, symbols + i, count - i);
+}
+
+#endif
+
+/* Returns the classifier named "scalar", "sse2" or "avx2", or the fastest one
+   that the processor supports if "name" is 0. Returns 0 if the classifier is
+   unknown or not supported.                                                   */
+static inline PulseClassifier GetPulseClassifier(const char *name)
+{
+#if defined(PULSES_X86)
+	__builtin_cpu_init();
+	bool avx2 = __builtin_cpu_supports("avx2"), sse2 = __builtin_cpu_supports("sse2");
+	if (!name) return avx2 ? ClassifyPulsesAVX2 : (sse2 ? ClassifyPulsesSSE2 : ClassifyPulsesScalar);
+	if (!strcmp(name, "avx2")) return avx2 ? ClassifyPulsesAVX2 : 0;
+	if (!strcmp(name, "sse2")) return sse2 ? ClassifyPulsesSSE2 : 0;
+#else
+	if (!name) return ClassifyPulsesScalar;
+#endif
+	if (!strcmp(name, "scalar")) return ClassifyPulsesScalar;
+	return 0;
+}
+
+/* Pulses of a signal. Each pulse is the high time and the low time before a
+   raise of the pin as the timer of the firmware measures them.                */
+struct PulseBlock
+{
+	uint16_t High[PULSE_BLOCK];
+	uint16_t Low[PULSE_BLOCK];
+	uint64_t Time[PULSE_BLOCK];   // time of the raise
+	uint8_t  Reset[PULSE_BLOCK];  // the overflow interrupt reset the decoder before the raise
+	uint8_t  Symbol[PULSE_BLOCK];
+	size_t   Count = 0;
+};
+
+/* Turns signal changes into pulses. It emulates the timer like EdgeDecoder of
+   ASKRmtCapture.h. The timer state does not depend on the decoder state: it is
+   stopped at the start and by the overflow interrupt, and the decoder is idle
+   while it is stopped, so the next raise always starts it.                    */
+struct PulseExtractor
+{
+	uint8_t  Level = 0xFF; // unknown
+	bool     TimerRunning = false;
+	bool     Reset = false;
+	uint64_t TimerBase = 0;
+	uint16_t HighTime = 0;
+	uint64_t Edges = 0;
+
+	/* Adds a signal change. Returns true if a pulse is added to the block.    */
+	inline bool Edge(uint64_t time, uint8_t level, PulseBlock &block)
+	{
+		if (level == Level) return false;
+		Level = level;
+		Edges++;
+		uint16_t tim = 0;
+		if (TimerRunning)
+		{
+			if (time - TimerBase > 0xFFFF)
+			{
+				TimerRunning = false;
+				Reset = true;
+			}
+			else
+				tim = (uint16_t)(time - TimerBase);
+		}
+		TimerBase = time;
+		if (!level)
+		{
+			HighTime = tim;
+			return false;
+		}
+		size_t n = block.Count++;
+		block.High[n] = HighTime;
+		block.Low[n] = tim;
+		block.Time[n] = time;
+		block.Reset[n] = Reset;
+		Reset = false;
+		TimerRunning = true;
+		return true;
+	}
+};
+
+/* Turns classified pulses into frames with the BitIndex logic of
+   ASKRmt_DecodeEdge. A frame is written into the last 3 bytes of Data.        */
+struct SymbolDecoder
+{
+	uint8_t BitIndex = ASKRmt_BITINDEX_IDLE;
+	uint8_t Data[ASKRmt_DATA_SIZE] = {};
+
+	/* Decodes the classified pulses of a block and calls "sink(time, data)"
+	   for each frame.                                                         */
+	template <typename Sink>
+	void Decode(const PulseBlock &block, Sink &sink)
+	{
+		uint8_t b = BitIndex;
+		uint8_t *code = Data + ASKRmt_DATA_SIZE - 3;
+		uint32_t bits = ((uint32_t)code[0] << 16) | ((uint32_t)code[1] << 8) | code[2]; // shift register, not aliased by the block
+		for (size_t i = 0; i < block.Count; i++)
+		{
+			uint8_t s = block.Symbol[i];
+			if (block.Reset[i]) b = ASKRmt_BITINDEX_IDLE;
+			if (24 > b)
+			{
+				if ((PULSE_ONE == s) || (PULSE_ZERO == s)) bits = (bits << 1) | (PULSE_ONE == s);
+				else b = ASKRmt_BITINDEX_INVALID;
+			}
+			else if (ASKRmt_BITINDEX_PREAMBLE == b)
+			{
+				if (PULSE_PREAMBLE == s) bits = 0;
+				else b = ASKRmt_BITINDEX_INVALID;
+			}
+			if (24 == ++b)
+			{
+				b = ASKRmt_BITINDEX_IDLE;
+				code[0] = bits >> 16;
+				code[1] = bits >> 8;
+				code[2] = bits;
+				sink(block.Time[i], Data);
+			}
+		}
+		code[0] = bits >> 16;
+		code[1] = bits >> 8;
+		code[2] = bits;
+		BitIndex = b;
+	}
+};
+
+#endif /* ASKRmtPulses_H_ */
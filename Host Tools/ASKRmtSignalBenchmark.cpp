@@ -0,0 +1,193 @@
+/*
+ * ASKRmtSignalBenchmark.cpp
+ *  Decode rate benchmark of the ASK RF remote controls signal decoder. It generates PT2262 or EV1527 transmissions of
+ *  random codes with ASKRmtSignalGenerator.h, decodes them with the state machine and the timer behavior of the
+ *  firmware and reports the decoded frames per second of CPU time and the frame recovery rate. The impairments are
+ *  swept from none to the given values, so each row is like a lower signal to noise ratio than the previous one.
+ *  With -c the frames are decoded with soft combining (ASKRmt_SOFTCOMBINING), so the recovery rates of both can be
+ *  compared with the same seed. Build it with -DASKRmt_ADAPTIVETIMING to decode with the adaptive pulse timing of
+ *  the default firmware configuration.
+ *
+ *  Usage: ASKRmtSignalBenchmark [-e ev1527|pt2262] [-w width] [-j jitter] [-d drift] [-g rate] [-a rate]
+ *         [-G width] [-m missing] [-r repeats] [-n transmissions] [-S steps] [-x seed] [-c] [-o capture]
+ *   -e  encoding. The default is ev1527.
+ *   -w  short pulse width in microseconds. The default is 350.
+ *   -j  standard deviation of the edge times in percent of the pulse width at the last step. The default is 15.
+ *   -d  largest transmitter clock error in percent. It is not swept. The default is 5.
+ *   -g  noise glitches per second in the transmissions at the last step. The default is 40.
+ *   -a  noise glitches per second in the gaps between the transmissions at the last step. The default is 1000.
+ *   -G  largest glitch length in microseconds. The default is 150.
+ *   -m  probability of a missing edge in percent at the last step. The default is 1.
+ *   -r  frames per transmission. The default is 4.
+ *   -n  transmissions per step. The default is 20000.
+ *   -S  number of steps after the step without impairments. 0 runs the given values only. The default is 10.
+ *   -x  random seed. The default is 1.
+ *   -c  decode with soft combining of the repeats.
+ *   -o  write the signal of the last step to a raw capture file for ASKRmtCaptureDecoder.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include "ASKRmtCapture.h"
+#include "ASKRmtSignalGenerator.h"
+
+/* Edge of the generated signal.                                               */
+struct GeneratedEdge
+{
+	uint64_t Time;
+	uint8_t  Level;
+};
+
+/* Results of one step.                                                        */
+struct SignalResult
+{
+	uint64_t Edges = 0, Frames = 0, Correct = 0, False = 0, Recovered = 0;
+	double   Seconds = 0;
+};
+
+static double CpuSeconds(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Generates "count" transmissions, decodes them and matches the frames with
+   the transmitted codes. A frame belongs to the transmission that was sent
+   last before it.                                                             */
+static SignalResult RunStep(const SignalParams &params, unsigned count, uint64_t seed, bool combine, const char *capture)
+{
+	SignalGenerator generator(params, seed);
+	std::vector<GeneratedEdge> edges;
+	std::vector<SignalTransmission> txs;
+	auto collect = [&](uint64_t time, uint8_t level) { edges.push_back({ time, level }); };
+	for (unsigned k = 0; k < count; k++) txs.push_back(generator.Transmit(generator.RandomCode(), collect));
+
+	struct Frame { uint64_t Time; uint64_t Code; };
+	std::vector<Frame> frames;
+	frames.reserve(count * params.Repeats);
+	SignalResult r;
+	EdgeDecoder decoder;
+	if (combine) decoder.EnableCombining();
+	double t0 = CpuSeconds();
+	for (const GeneratedEdge &e : edges)
+		if (decoder.Edge(e.Time, e.Level))
+		{
+			uint64_t code = 0; // the bytes before the last 3 bytes are 0 for the 24-bit codes
+			for (int i = 0; i < ASKRmt_DATA_SIZE; i++) code = (code << 8) | decoder.Data[i];
+			frames.push_back({ e.Time, code });
+		}
+	r.Seconds = CpuSeconds() - t0;
+	r.Edges = decoder.Edges;
+	r.Frames = frames.size();
+
+	size_t k = 0;
+	uint64_t lastRecovered = ~0ULL;
+	for (const Frame &f : frames)
+	{
+		while ((k + 1 < txs.size()) && (txs[k + 1].Start <= f.Time)) k++;
+		if ((f.Time >= txs[k].Start) && (f.Code == txs[k].Code))
+		{
+			r.Correct++;
+			if (lastRecovered != k) { r.Recovered++; lastRecovered = k; }
+		}
+		else
+			r.False++;
+	}
+
+	if (capture)
+	{
+		FILE *file = fopen(capture, "wb");
+		if (file)
+		{
+			for (const GeneratedEdge &e : edges)
+			{
+				uint64_t w = e.Time | ((uint64_t)e.Level << 63);
+				fwrite(&w, 8, 1, file);
+			}
+			if (fclose(file)) file = 0;
+		}
+		if (!file) fprintf(stderr, "Can not write the capture file: %s\n", capture);
+	}
+	return r;
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "Usage: ASKRmtSignalBenchmark [-e ev1527|pt2262] [-w width] [-j jitter] [-d drift] [-g rate] [-a rate]\n"
+		"       [-G width] [-m missing] [-r repeats] [-n transmissions] [-S steps] [-x seed] [-c] [-o capture]\n");
+}
+
+int main(int argc, char **argv)
+{
+	SignalParams params;
+	params.Jitter = 15;
+	params.Drift = 5;
+	params.GlitchRate = 40;
+	params.GapGlitchRate = 1000;
+	params.GlitchWidth = 150;
+	params.MissingEdges = 1;
+	unsigned count = 20000, steps = 10;
+	uint64_t seed = 1;
+	const char *capture = 0;
+	bool combine = false;
+	int opt;
+	while ((opt = getopt(argc, argv, "e:w:j:d:g:a:G:m:r:n:S:x:co:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'e':
+				if (!strcmp(optarg, "ev1527")) params.Encoding = SIGNAL_EV1527;
+				else if (!strcmp(optarg, "pt2262")) params.Encoding = SIGNAL_PT2262;
+				else { Usage(); return 2; }
+				break;
+			case 'w': params.PulseWidth = strtod(optarg, 0); break;
+			case 'j': params.Jitter = strtod(optarg, 0); break;
+			case 'd': params.Drift = strtod(optarg, 0); break;
+			case 'g': params.GlitchRate = strtod(optarg, 0); break;
+			case 'a': params.GapGlitchRate = strtod(optarg, 0); break;
+			case 'G': params.GlitchWidth = strtod(optarg, 0); break;
+			case 'm': params.MissingEdges = strtod(optarg, 0); break;
+			case 'r': params.Repeats = strtoul(optarg, 0, 10); break;
+			case 'n': count = strtoul(optarg, 0, 10); break;
+			case 'S': steps = strtoul(optarg, 0, 10); break;
+			case 'x': seed = strtoull(optarg, 0, 10); break;
+			case 'c': combine = true; break;
+			case 'o': capture = optarg; break;
+			default: Usage(); return 2;
+		}
+	}
+	if (!count || !params.Repeats || params.PulseWidth < 1) { Usage(); return 2; }
+
+	printf("%s, %.0f us pulses, %.1f%% drift, %u frames per transmission, %u transmissions per step%s\n",
+		SIGNAL_EV1527 == params.Encoding ? "EV1527" : "PT2262", params.PulseWidth, params.Drift, params.Repeats, count,
+		combine ? ", soft combining" : "");
+	printf("step  jitter%%  glitch/s  gap glitch/s  missing%%     frames    correct     false  recovered%%  frames%%  M frames/s  M edges/s\n");
+	for (unsigned s = (steps ? 0 : 1), n = (steps ? steps : 1); s <= n; s++)
+	{
+		SignalParams p = params;
+		double level = (double)s / n;
+		p.Jitter *= level;
+		p.GlitchRate *= level;
+		p.GapGlitchRate *= level;
+		p.MissingEdges *= level;
+		SignalResult r = RunStep(p, count, seed, combine, (s == n) ? capture : 0);
+		printf("%4u  %7.2f  %8.0f  %12.0f  %8.2f  %9llu  %9llu  %8llu  %10.2f  %7.2f  %10.2f  %9.1f\n", s, p.Jitter, p.GlitchRate, p.GapGlitchRate, p.MissingEdges,
+			(unsigned long long)r.Frames, (unsigned long long)r.Correct, (unsigned long long)r.False,
+			100.0 * r.Recovered / count, 100.0 * r.Correct / ((double)count * params.Repeats),
+			r.Seconds > 0 ? r.Frames / r.Seconds * 1e-6 : 0.0, r.Seconds > 0 ? r.Edges / r.Seconds * 1e-6 : 0.0);
+	}
+	return 0;
+}
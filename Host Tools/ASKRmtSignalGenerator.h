@@ -0,0 +1,196 @@
+/*
+ * ASKRmtSignalGenerator.h
+ *  Synthetic ASK RF remote control signals for the host tools. It generates the pin changes of PT2262 and EV1527
+ *  transmissions with timing jitter, transmitter clock drift, noise glitches and missing edges, so the decoder can be
+ *  measured with a reproducible signal. Glitches are the noise that the receiver outputs as short highs while the
+ *  carrier is off.
+ *   EV1527: (preamble, 24 bits) is repeated. The preamble is 1 high and 31 low pulse widths.
+ *   PT2262: (12 trits, sync) is repeated. Trits 0, 1 and F are the bit pairs 00, 11 and 01 and the sync is 1 high
+ *           and 31 low pulse widths.
+ *  A 0 bit is 1 high and 3 low pulse widths and a 1 bit is 3 high and 1 low pulse widths.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#ifndef ASKRmtSignalGenerator_H_
+#define ASKRmtSignalGenerator_H_
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+
+enum SignalEncoding { SIGNAL_EV1527, SIGNAL_PT2262 };
+
+/* Parameters of the generated signal.                                         */
+struct SignalParams
+{
+	SignalEncoding Encoding = SIGNAL_EV1527;
+	double   PulseWidth = 350;   // short pulse in microseconds
+	double   Jitter = 0;         // standard deviation of the edge times in percent of the pulse width
+	double   Drift = 0;          // largest clock error of a transmitter in percent
+	double   GlitchRate = 0;     // noise glitches (spurious highs while the carrier is off) per second in the transmissions
+	double   GapGlitchRate = 0;  // noise glitches per second in the gaps between the transmissions
+	double   GlitchWidth = 100;  // largest glitch length in microseconds
+	double   MissingEdges = 0;   // probability of a lost edge in percent
+	unsigned Repeats = 4;        // frames per transmission
+	double   Gap = 100000;       // silence after each transmission in microseconds
+};
+
+/* Transmission of the generated signal.                                       */
+struct SignalTransmission
+{
+	uint64_t Start, End; // times of the first and the last edges
+	uint32_t Code;       // 24-bit code
+};
+
+/* Reproducible random numbers (splitmix64).                                   */
+struct SignalRandom
+{
+	uint64_t State;
+
+	uint64_t Next()
+	{
+		uint64_t z = (State += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	/* Uniform in [0, 1).                                                      */
+	double Uniform() { return (Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	/* Standard normal (Box-Muller).                                           */
+	double Normal()
+	{
+		double u = Uniform();
+		return sqrt(-2 * log(1 - u)) * cos(2 * M_PI * Uniform());
+	}
+};
+
+/* Generator of a signal made of transmissions of random codes.                */
+struct SignalGenerator
+{
+	SignalParams Params;
+	SignalRandom Random;
+	double       Time = 1000;           // start of the next transmission in microseconds
+	double       NextGlitch = 0;        // start time of the next glitch
+	std::vector<double> Times;          // edge times of the transmission being generated
+	std::vector<uint8_t> Levels;
+
+	SignalGenerator(const SignalParams &params, uint64_t seed) : Params(params) { Random.State = seed; }
+
+	/* Random code of the encoding.                                            */
+	uint32_t RandomCode()
+	{
+		if (SIGNAL_EV1527 == Params.Encoding) return (uint32_t)Random.Next() & 0xFFFFFF;
+		static const uint8_t trits[3] = { 0, 3, 1 }; // 0, 1, F
+		uint32_t code = 0;
+		for (int i = 0; i < 12; i++) code = (code << 2) | trits[Random.Next() % 3];
+		return code;
+	}
+
+	/* Appends the ideal edges of a high and a low pulse.                      */
+	void Pulse(double &t, double high, double low, double width)
+	{
+		Times.push_back(t); Levels.push_back(1);
+		t += high * width;
+		Times.push_back(t); Levels.push_back(0);
+		t += low * width;
+	}
+
+	/* Generates a transmission of "code" and the gap after it and passes its
+	   edges to "sink(time, level)" in time order.                             */
+	template <typename Sink>
+	SignalTransmission Transmit(uint32_t code, Sink &sink)
+	{
+		const SignalParams &p = Params;
+		double width = p.PulseWidth * (1 + p.Drift / 100 * (2 * Random.Uniform() - 1));
+		double t = Time;
+		Times.clear();
+		Levels.clear();
+		for (unsigned r = 0; r < p.Repeats; r++)
+		{
+			if (SIGNAL_EV1527 == p.Encoding) Pulse(t, 1, 31, width);
+			for (int i = 23; i >= 0; i--)
+				if ((code >> i) & 1) Pulse(t, 3, 1, width);
+				else Pulse(t, 1, 3, width);
+			if (SIGNAL_PT2262 == p.Encoding) Pulse(t, 1, 31, width);
+		}
+		// jitter and missing edges
+		double sigma = p.Jitter / 100 * p.PulseWidth, last = Time;
+		size_t n = 0;
+		for (size_t i = 0; i < Times.size(); i++)
+		{
+			if (p.MissingEdges > 0 && Random.Uniform() * 100 < p.MissingEdges) continue;
+			double e = Times[i] + (sigma > 0 ? sigma * Random.Normal() : 0);
+			if (e < last + 1) e = last + 1; // edges keep their order
+			last = e;
+			Times[n] = e;
+			Levels[n] = Levels[i];
+			n++;
+		}
+		Times.resize(n);
+		Levels.resize(n);
+		double end = t + p.Gap;
+		if (last + 1 > end) end = last + 1;
+
+		// merge with the glitches: the receiver output is high during a glitch
+		SignalTransmission tx = { (uint64_t)(Time + 0.5), (uint64_t)(last + 0.5), code };
+		uint8_t ideal = 0, out = 0;
+		bool glitch = false;
+		double glitchEnd = 0;
+		ScheduleGlitch(Time, t); // glitches are a Poisson process, so the next one can be drawn again at any time
+		size_t i = 0;
+		for (;;)
+		{
+			double tg = glitch ? glitchEnd : NextGlitch;
+			if ((i >= n) && (tg >= end)) break;
+			double now;
+			if ((i < n) && (Times[i] <= tg)) { now = Times[i]; ideal = Levels[i++]; }
+			else
+			{
+				now = tg;
+				if (glitch) { glitch = false; ScheduleGlitch(now, t); }
+				else { glitch = true; glitchEnd = now + 1 + Random.Uniform() * p.GlitchWidth; }
+			}
+			uint8_t level = ideal | (glitch ? 1 : 0);
+			if (level != out)
+			{
+				out = level;
+				sink((uint64_t)(now + 0.5), level);
+			}
+		}
+		if (out) sink((uint64_t)(end + 0.5), 0); // a glitch ends with the gap
+		Time = end;
+		return tx;
+	}
+
+	/* Draws the start time of the next glitch after "now". The rate changes at
+	   the end of the transmission "txEnd".                                    */
+	void ScheduleGlitch(double now, double txEnd)
+	{
+		if (now < txEnd)
+		{
+			NextGlitch = now + GlitchDelay(Params.GlitchRate);
+			if (NextGlitch <= txEnd) return;
+			now = txEnd;
+		}
+		NextGlitch = now + GlitchDelay(Params.GapGlitchRate);
+	}
+
+	/* Random time to the next glitch of a Poisson process.                    */
+	double GlitchDelay(double rate)
+	{
+		if (rate <= 0) return 1e300;
+		return -log(1 - Random.Uniform()) * 1e6 / rate;
+	}
+};
+
+#endif /* ASKRmtSignalGenerator_H_ */
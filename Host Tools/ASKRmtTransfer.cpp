@@ -0,0 +1,326 @@
+/*
+ * ASKRmtTransfer.cpp
+ *  Host side of the bulk transfer protocol of ASKRemoteControlTransfer.h. It exports the saved remote controls or keys
+ *  of a device that calls ASKRmt_TransferReceivedByte for its UART to a file, or replaces them with the codes of a
+ *  file. The file has one code per line as 6 hexadecimal digits (the 3 bytes of the code), and the text after '#' is
+ *  a comment. Each request is sent again if no valid response is received in time.
+ *
+ *  Usage: ASKRmtTransfer [-b baud] [-t timeout] [-r retries] device info|export [file]|import file
+ *   -b  baud rate of the serial port. The default is 9600 (the test project).
+ *   -t  response timeout in milliseconds. The default is 5000, enough for the EEPROM writes of a block.
+ *   -r  retries of each request. The default is 5.
+ *   info    prints the slot count and the kind of the saved codes.
+ *   export  writes the saved codes to the file or to the standard output.
+ *   import  replaces the saved codes with the codes of the file. Repeated codes are imported once, and the codes
+ *           are sorted if the device has the sorted store. The other stores keep the order of the file, so
+ *           importing an exported file writes nothing.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "../ASK Remote Control Decoder/ASKRemoteControlTransfer.h"
+
+static int      Port = -1;
+static int      Timeout = 5000;
+static unsigned Retries = 5;
+
+static const char *StatusText(uint8_t status)
+{
+	switch (status)
+	{
+		case ASKRmt_TRANSFER_OK:       return "ok";
+		case ASKRmt_TRANSFER_REJECTED: return "rejected: the store is full or a code is invalid";
+		case ASKRmt_TRANSFER_SEQUENCE: return "unexpected block number";
+		case ASKRmt_TRANSFER_NOIMPORT: return "no import is started";
+		case ASKRmt_TRANSFER_INVALID:  return "invalid request";
+		default:                       return "unknown status";
+	}
+}
+
+static speed_t BaudConstant(unsigned baud)
+{
+	switch (baud)
+	{
+		case 1200:   return B1200;
+		case 2400:   return B2400;
+		case 4800:   return B4800;
+		case 9600:   return B9600;
+		case 19200:  return B19200;
+		case 38400:  return B38400;
+		case 57600:  return B57600;
+		case 115200: return B115200;
+		default:     return 0;
+	}
+}
+
+static bool OpenPort(const char *device, unsigned baud)
+{
+	speed_t speed = BaudConstant(baud);
+	if (!speed)
+	{
+		fprintf(stderr, "unsupported baud rate %u\n", baud);
+		return false;
+	}
+	Port = open(device, O_RDWR | O_NOCTTY);
+	if (Port < 0)
+	{
+		perror(device);
+		return false;
+	}
+	struct termios t;
+	if (0 == tcgetattr(Port, &t)) // a pseudo terminal of the device stand-in is configured too
+	{
+		cfmakeraw(&t);
+		cfsetispeed(&t, speed);
+		cfsetospeed(&t, speed);
+		t.c_cflag |= CLOCAL | CREAD;
+		t.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+		t.c_cc[VMIN] = 0;
+		t.c_cc[VTIME] = 0;
+		tcsetattr(Port, TCSANOW, &t);
+	}
+	return true;
+}
+
+static void PortSend(uint8_t byte)
+{
+	static std::vector<uint8_t> frame;
+	frame.push_back(byte);
+	// the frame is written at once when its CRC is sent
+	if ((frame.size() >= 5) && (frame.size() == frame[2] + 5u))
+	{
+		if (write(Port, frame.data(), frame.size()) != (ssize_t)frame.size()) perror("write");
+		frame.clear();
+	}
+}
+
+static int64_t Milliseconds(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (int64_t)t.tv_sec * 1000 + t.tv_nsec / 1000000;
+}
+
+/* Sends a request and receives its response. A NACK is also a response. Returns
+   false if no expected response is received after the retries.                */
+static bool Request(uint8_t type, const uint8_t *payload, uint8_t length, uint8_t responseType,
+	ASKRmt_TransferReceiver *response)
+{
+	for (unsigned attempt = 0; attempt <= Retries; attempt++)
+	{
+		tcflush(Port, TCIFLUSH); // drop the decoded frames and the late responses
+		memset(response, 0, sizeof(*response));
+		ASKRmt_TransferSend(type, payload, length, PortSend);
+		int64_t end = Milliseconds() + Timeout;
+		for (int64_t now = Milliseconds(); now < end; now = Milliseconds())
+		{
+			struct pollfd p = { Port, POLLIN, 0 };
+			if (poll(&p, 1, (int)(end - now)) <= 0) break;
+			uint8_t bytes[256];
+			ssize_t n = read(Port, bytes, sizeof(bytes));
+			if (n <= 0) break;
+			for (ssize_t i = 0; i < n; i++)
+				if (ASKRmt_TransferReceive(response, bytes[i]) &&
+					((responseType == response->Type) || (ASKRmt_TRANSFER_NACK == response->Type)))
+					return true;
+		}
+		if (attempt < Retries) fprintf(stderr, "no response to '%c', retrying\n", type);
+	}
+	fprintf(stderr, "the device does not respond\n");
+	return false;
+}
+
+struct DeviceInfo
+{
+	uint16_t Slots;
+	uint8_t  BlockCodes;
+	uint8_t  Flags;
+	uint8_t  Version;
+};
+
+static bool GetInfo(DeviceInfo *info)
+{
+	ASKRmt_TransferReceiver r;
+	if (!Request(ASKRmt_TRANSFER_INFO, 0, 0, ASKRmt_TRANSFER_DEVICE, &r)) return false;
+	if ((ASKRmt_TRANSFER_DEVICE != r.Type) || (r.Length < 5))
+	{
+		fprintf(stderr, "invalid info response\n");
+		return false;
+	}
+	info->Slots = r.Payload[0] | (r.Payload[1] << 8);
+	info->BlockCodes = r.Payload[2];
+	info->Flags = r.Payload[3];
+	info->Version = r.Payload[4];
+	if (ASKRmt_TRANSFER_VERSION != info->Version)
+	{
+		fprintf(stderr, "unsupported protocol version %u\n", info->Version);
+		return false;
+	}
+	return true;
+}
+
+/* Sends an import request and checks its acknowledge.                         */
+static bool ImportRequest(uint8_t type, const uint8_t *payload, uint8_t length, uint16_t block)
+{
+	ASKRmt_TransferReceiver r;
+	if (!Request(type, payload, length, ASKRmt_TRANSFER_ACK, &r)) return false;
+	uint8_t status = (r.Length >= 3) ? r.Payload[2] : ASKRmt_TRANSFER_INVALID;
+	if ((ASKRmt_TRANSFER_ACK == r.Type) && (ASKRmt_TRANSFER_OK == status)) return true;
+	fprintf(stderr, "block %u: %s\n", block, StatusText(status));
+	return false;
+}
+
+static int Info(void)
+{
+	DeviceInfo info;
+	if (!GetInfo(&info)) return 1;
+	printf("%u %s slots, %s store, %u codes per block, protocol version %u\n", info.Slots,
+		(info.Flags & ASKRmt_TRANSFER_KEYS) ? "key" : "remote control",
+		(info.Flags & ASKRmt_TRANSFER_SORTED) ? "sorted" : "slot", info.BlockCodes, info.Version);
+	return 0;
+}
+
+static int Export(const char *path)
+{
+	DeviceInfo info;
+	if (!GetInfo(&info)) return 1;
+	FILE *f = path ? fopen(path, "w") : stdout;
+	if (!f)
+	{
+		perror(path);
+		return 1;
+	}
+	unsigned codes = 0;
+	for (uint16_t block = 0; ; block++)
+	{
+		uint8_t payload[2] = { (uint8_t)block, (uint8_t)(block >> 8) };
+		ASKRmt_TransferReceiver r;
+		if (!Request(ASKRmt_TRANSFER_EXPORT, payload, 2, ASKRmt_TRANSFER_BLOCK, &r)) return 1;
+		if ((ASKRmt_TRANSFER_BLOCK != r.Type) || (r.Length < 2) || ((r.Length - 2) % 3) ||
+			((r.Payload[0] | (r.Payload[1] << 8)) != block))
+		{
+			fprintf(stderr, "block %u: %s\n", block, (ASKRmt_TRANSFER_NACK == r.Type) ? StatusText(r.Payload[2]) : "invalid response");
+			return 1;
+		}
+		if (2 == r.Length) break;
+		for (uint8_t i = 2; i < r.Length; i += 3, codes++)
+			fprintf(f, "%02X%02X%02X\n", r.Payload[i], r.Payload[i + 1], r.Payload[i + 2]);
+	}
+	if (path) fclose(f);
+	fprintf(stderr, "%u codes exported\n", codes);
+	return 0;
+}
+
+/* Reads the codes of a file. Returns false if a line is not a code.           */
+static bool ReadCodes(const char *path, std::vector<uint32_t> *codes)
+{
+	FILE *f = fopen(path, "r");
+	if (!f)
+	{
+		perror(path);
+		return false;
+	}
+	std::set<uint32_t> seen;
+	char line[256];
+	for (unsigned number = 1; fgets(line, sizeof(line), f); number++)
+	{
+		char *comment = strchr(line, '#');
+		if (comment) *comment = 0;
+		char *p = line, *end;
+		while (isspace((unsigned char)*p)) p++;
+		if (!*p) continue;
+		unsigned long code = strtoul(p, &end, 16);
+		bool digits = (6 == end - p);
+		while (isspace((unsigned char)*end)) end++;
+		if (!digits || *end || (0xFF == (code & 0xFF))) // the 3rd byte 0xFF marks a free slot
+		{
+			fprintf(stderr, "%s:%u: invalid code\n", path, number);
+			fclose(f);
+			return false;
+		}
+		if (seen.insert(code).second) codes->push_back(code);
+	}
+	fclose(f);
+	return true;
+}
+
+static int Import(const char *path)
+{
+	std::vector<uint32_t> codes;
+	if (!ReadCodes(path, &codes)) return 1;
+	DeviceInfo info;
+	if (!GetInfo(&info)) return 1;
+	if (info.Flags & ASKRmt_TRANSFER_SORTED) std::sort(codes.begin(), codes.end());
+	if (codes.size() > info.Slots)
+	{
+		fprintf(stderr, "%zu codes do not fit in %u slots\n", codes.size(), info.Slots);
+		return 1;
+	}
+	if (!ImportRequest(ASKRmt_TRANSFER_BEGIN, 0, 0, 0)) return 1;
+	uint16_t block = 0;
+	for (size_t i = 0; i < codes.size(); block++)
+	{
+		uint8_t payload[ASKRmt_TRANSFER_MAXPAYLOAD] = { (uint8_t)block, (uint8_t)(block >> 8) };
+		uint8_t length = 2;
+		for (; (i < codes.size()) && (length + 3 <= 2 + info.BlockCodes * 3) && (length + 3 <= ASKRmt_TRANSFER_MAXPAYLOAD); i++)
+		{
+			payload[length++] = codes[i] >> 16;
+			payload[length++] = codes[i] >> 8;
+			payload[length++] = codes[i];
+		}
+		if (!ImportRequest(ASKRmt_TRANSFER_CODES, payload, length, block)) return 1;
+	}
+	if (!ImportRequest(ASKRmt_TRANSFER_FINISH, 0, 0, block)) return 1;
+	fprintf(stderr, "%zu codes imported in %u blocks\n", codes.size(), block);
+	return 0;
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "Usage: ASKRmtTransfer [-b baud] [-t timeout] [-r retries] device info|export [file]|import file\n");
+}
+
+int main(int argc, char **argv)
+{
+	unsigned baud = 9600;
+	int opt;
+	while ((opt = getopt(argc, argv, "b:t:r:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'b': baud = strtoul(optarg, 0, 10); break;
+			case 't': Timeout = atoi(optarg); break;
+			case 'r': Retries = strtoul(optarg, 0, 10); break;
+			default: Usage(); return 2;
+		}
+	}
+	if ((argc - optind < 2) || (Timeout <= 0)) { Usage(); return 2; }
+	const char *device = argv[optind], *command = argv[optind + 1], *path = (argc - optind > 2) ? argv[optind + 2] : 0;
+	bool import = !strcmp(command, "import");
+	if ((!import && strcmp(command, "export") && strcmp(command, "info")) || (import && !path)) { Usage(); return 2; }
+	if (!OpenPort(device, baud)) return 1;
+
+	if (import) return Import(path);
+	if (!strcmp(command, "export")) return Export(path);
+	return Info();
+}
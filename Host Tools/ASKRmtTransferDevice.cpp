@@ -0,0 +1,142 @@
+/*
+ * ASKRmtTransferDevice.cpp
+ *  Stand-in of a device for ASKRmtTransfer. It serves the bulk transfer protocol of ASKRemoteControlTransfer.h on a
+ *  pseudo terminal with the decoder library and its host HAL, so the host tool can be tried without the hardware.
+ *  It prints the name of the pseudo terminal and serves it until it is killed. The saved codes are kept in the
+ *  storage file, and after each import the number of the changed storage bytes is printed.
+ *
+ *  Usage: ASKRmtTransferDevice [-s storage] [-l link]
+ *   -s  storage file. It is created if it is missing. By default the storage is not kept.
+ *   -l  symbolic link to the pseudo terminal, for example /tmp/ttyASKRmt.
+ *  Build it with the library sources and the configuration of ASKRemoteControlDecoder.h, which must save the remote
+ *  controls or the keys.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <vector>
+#include "ASKRemoteControlDecoder.h"
+#include "ASKRemoteControlHAL.h"
+#include "ASKRemoteControlTransfer.h"
+
+#if !defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) && !defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+#error "ASKRmtTransferDevice needs ASKRmt_SAVEREMOTECONTROLSTOEEPROM or ASKRmt_SAVEKEYCODESTOEEPROM"
+#endif
+
+static int Master = -1;
+static const char *Link = 0;
+
+static void MasterSend(uint8_t byte)
+{
+	if (write(Master, &byte, 1) != 1) perror("write");
+}
+
+static void ReadStorage(std::vector<uint8_t> *bytes)
+{
+	bytes->resize(ASKRmtHost_STORAGE_SIZE);
+	for (long i = 0; i < ASKRmtHost_STORAGE_SIZE; i += 256)
+		ASKRmtHost_StorageReadBlock(bytes->data() + i, i, 256);
+}
+
+static void Stop(int)
+{
+	if (Link) unlink(Link);
+	_exit(0);
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "Usage: ASKRmtTransferDevice [-s storage] [-l link]\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *storage = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "s:l:")) != -1)
+	{
+		switch (opt)
+		{
+			case 's': storage = optarg; break;
+			case 'l': Link = optarg; break;
+			default: Usage(); return 2;
+		}
+	}
+	if (optind != argc) { Usage(); return 2; }
+	if (storage && !ASKRmtHost_OpenStorageFile(storage)) return 1;
+
+	Master = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((Master < 0) || grantpt(Master) || unlockpt(Master))
+	{
+		perror("posix_openpt");
+		return 1;
+	}
+	const char *name = ptsname(Master);
+	int slave = open(name, O_RDWR | O_NOCTTY); // kept open, so the master is not closed when the host tool exits
+	struct termios t;
+	if ((slave < 0) || tcgetattr(slave, &t))
+	{
+		perror(name);
+		return 1;
+	}
+	cfmakeraw(&t);
+	tcsetattr(slave, TCSANOW, &t);
+	if (Link)
+	{
+		unlink(Link);
+		if (symlink(name, Link))
+		{
+			perror(Link);
+			return 1;
+		}
+		signal(SIGINT, Stop);
+		signal(SIGTERM, Stop);
+	}
+	printf("%s\n", Link ? Link : name);
+	fflush(stdout);
+
+	ASKRmt_Init();
+	ASKRmt_TransferReceiver frames = {}; // watches the requests to count the changed bytes of each import
+	std::vector<uint8_t> before, after;
+	uint8_t bytes[256];
+	for (;;)
+	{
+		ssize_t n = read(Master, bytes, sizeof(bytes));
+		if (n <= 0)
+		{
+			perror("read");
+			return 1;
+		}
+		for (ssize_t i = 0; i < n; i++)
+		{
+			bool frame = ASKRmt_TransferReceive(&frames, bytes[i]);
+			if (frame && (ASKRmt_TRANSFER_BEGIN == frames.Type)) ReadStorage(&before);
+			ASKRmt_TransferReceivedByte(bytes[i], MasterSend);
+			ASKRmt_FlushEEPROMWrites();
+			if (frame && (ASKRmt_TRANSFER_FINISH == frames.Type) && !before.empty())
+			{
+				ReadStorage(&after);
+				unsigned changed = 0;
+				for (size_t j = 0; j < after.size(); j++) changed += (before[j] != after[j]);
+				printf("import finished, %u storage bytes changed\n", changed);
+				fflush(stdout);
+				before.clear();
+			}
+		}
+	}
+}
@@ -0,0 +1,173 @@
+/*
+ * ASKRmtWriteQueueTest.cpp
+ *  Test of the EEPROM write queue of the decoder library with its host HAL. The host HAL raises the EEPROM ready
+ *  interrupt between the address load and the read of each byte read while writes are queued, like it can occur on
+ *  an AVR, so a read that does not keep the interrupt from starting a queued write returns a wrong byte. The test
+ *  imports random lists of remote controls, deletes some of them and deletes all of them without flushing the queue
+ *  and checks the saved remote controls against the expected ones, before and after the queue is flushed and after
+ *  the storage is opened again. It prints the first difference and returns 1 if a check fails.
+ *
+ *  Usage: ASKRmtWriteQueueTest [-n rounds] [-x seed]
+ *   -n  rounds of operations. The default is 2000.
+ *   -x  random seed. The default is 1.
+ *  Build it with the library sources and the configuration of ASKRemoteControlDecoder.h, which must save the remote
+ *  controls and define ASKRmt_EEPROMWRITEQUEUE_SIZE.
+ *
+ * This program is published under the terms of the MIT License.
+ * This program is free software and can be distributed by everyone.
+ * You can modify this program and distribute it with your name and contact information as the author.
+ * No warranty of any kind is expressed or implied. You use this program at your own risk.
+ *
+ *   Created: 16 Oct 2026
+ *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
+ * Last Edit: 16 Oct 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <algorithm>
+#include <vector>
+#include "ASKRemoteControlDecoder.h"
+#include "ASKRemoteControlHAL.h"
+
+#if !defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || !(ASKRmt_EEPROMWRITEQUEUE_SIZE > 0)
+#error "ASKRmtWriteQueueTest needs ASKRmt_SAVEREMOTECONTROLSTOEEPROM and ASKRmt_EEPROMWRITEQUEUE_SIZE"
+#endif
+
+typedef std::vector<uint32_t> CodeList; // codes as byte 0 << 16 | byte 1 << 8 | byte 2, ascending
+
+static uint32_t Random = 3; // 2 * seed + 1, never 0
+
+static uint32_t NextRandom(void)
+{
+	Random ^= Random << 13;
+	Random ^= Random >> 17;
+	Random ^= Random << 5;
+	return Random;
+}
+
+/* Returns a random LearningCode remote control of a few byte values, so the
+   bytes of the queued writes often equal the bytes that are read. The low
+   nibble of the 3rd byte is 0, so a code only matches itself.                 */
+static uint32_t RandomCode(void)
+{
+	static const uint8_t values[] = { 0x00, 0x11, 0x20, 0x31 };
+	uint32_t code = 0;
+	for (int i = 0; i < 3; i++) code = (code << 8) | values[NextRandom() % sizeof(values)];
+	return code & 0xFFFFF0;
+}
+
+static void CodeBytes(uint32_t code, uint8_t *bytes)
+{
+	bytes[0] = code >> 16;
+	bytes[1] = code >> 8;
+	bytes[2] = code;
+}
+
+/* Returns the saved remote controls in ascending order.                       */
+static CodeList SavedCodes(void)
+{
+	CodeList codes;
+	uint8_t code[3];
+	for (uint16_t i = 0; ASKRmt_GetRemoteCodeByIndex(i, code); i++)
+		if (0xFF != code[2]) codes.push_back(((uint32_t)code[0] << 16) | (code[1] << 8) | code[2]);
+	std::sort(codes.begin(), codes.end());
+	return codes;
+}
+
+/* Compares the saved remote controls with the expected ones. Prints the
+   first difference and returns false if they differ.                          */
+static bool Check(unsigned round, const char *step, const CodeList &expected)
+{
+	CodeList saved = SavedCodes();
+	if (saved == expected) return true;
+	size_t i = 0;
+	while ((i < saved.size()) && (i < expected.size()) && (saved[i] == expected[i])) i++;
+	printf("round %u %s: %zu codes are saved instead of %zu", round, step, saved.size(), expected.size());
+	if (i < saved.size()) printf(", %06X is saved", (unsigned)saved[i]);
+	if (i < expected.size()) printf(", %06X is expected", (unsigned)expected[i]);
+	printf("\n");
+	return false;
+}
+
+static void Usage(void)
+{
+	fprintf(stderr, "Usage: ASKRmtWriteQueueTest [-n rounds] [-x seed]\n");
+}
+
+int main(int argc, char **argv)
+{
+	unsigned rounds = 2000;
+	int opt;
+	while ((opt = getopt(argc, argv, "n:x:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': rounds = strtoul(optarg, 0, 0); break;
+			case 'x': Random = 2 * strtoul(optarg, 0, 0) + 1; break;
+			default: Usage(); return 2;
+		}
+	}
+	if (optind != argc) { Usage(); return 2; }
+
+	ASKRmt_Init();
+	CodeList expected;
+	unsigned long long queuedWrites = 0;
+	for (unsigned round = 0; round < rounds; round++)
+	{
+		uint8_t bytes[3];
+		switch (NextRandom() % 4)
+		{
+			case 0:
+			case 1: // the sorted store needs the imported codes in ascending order
+			{
+				CodeList codes;
+				unsigned n = NextRandom() % (ASKRmt_GetSlotCount() + 1);
+				for (unsigned i = 0; i < n; i++) codes.push_back(RandomCode());
+				std::sort(codes.begin(), codes.end());
+				codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+				ASKRmt_BeginImport();
+				for (uint32_t code : codes)
+				{
+					CodeBytes(code, bytes);
+					if (!ASKRmt_ImportCode(bytes))
+					{
+						printf("round %u: %06X is not imported\n", round, (unsigned)code);
+						return 1;
+					}
+				}
+				ASKRmt_EndImport();
+				expected = codes;
+				break;
+			}
+			case 2:
+			{
+				uint32_t code = expected.size() && (NextRandom() & 1) ? expected[NextRandom() % expected.size()] : RandomCode();
+				CodeBytes(code, bytes);
+				CodeList::iterator saved = std::find(expected.begin(), expected.end(), code);
+				if (ASKRmt_DeleteRemoteByCode(bytes) != (saved != expected.end()))
+				{
+					printf("round %u: %06X is %sdeleted\n", round, (unsigned)code, (saved != expected.end()) ? "not " : "");
+					return 1;
+				}
+				if (saved != expected.end()) expected.erase(saved);
+				break;
+			}
+			default:
+				ASKRmt_DeleteAllRemotes();
+				expected.clear();
+				break;
+		}
+		queuedWrites += ASKRmt_PendingEEPROMWrites();
+		if (!Check(round, "with queued writes", expected)) return 1;
+		if (NextRandom() % 4) continue; // the next operation also reads while writes are queued
+		ASKRmt_FlushEEPROMWrites();
+		if (!Check(round, "after the flush", expected)) return 1;
+		ASKRmt_Init(); // reads the saved codes from the storage again
+		if (!Check(round, "after opening the storage", expected)) return 1;
+	}
+	printf("%u rounds, %llu queued writes after the operations, all codes are saved as expected\n", rounds, queuedWrites);
+	return 0;
+}
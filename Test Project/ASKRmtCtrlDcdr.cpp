@@ -4,17 +4,29 @@
  *  Fuse Bits: H=0xD9 L=0xE1
  *  Operation modes:
  *   Normal mode (PB0:H, PB1:H, PB2:H) [LED on PB3 is off]: When pressing any key on the remote control, the data 
- *    will be sent to the UART and if the remote control/key code has already saved, the key code will be 
- *    displayed by LEDs on pins PC0 to PC3.
+ *    will be reported to the UART and if the remote control/key code has already saved, the key code will be 
+ *    displayed by LEDs on pins PC0 to PC3 while the key is held.
  *   Add mode (PB0:L, PB1:H, PB2:H) [LED on PB3 is on]: The remote control will be saved by pressing key 1 or A 
  *    in "save remote controls" mode. The key code will be saved by pressing any key in "save keys" mode. After a 
- *    successful operation LED on PB3 will blink fast 10 times. The data will be sent to the UART and the key code 
- *    will be displayed by LEDs on pins PC0 to PC3.
+ *    successful operation LED on PB3 will blink fast 10 times. The data will be reported to the UART and the key 
+ *    code will be displayed by LEDs on pins PC0 to PC3 while the key is held.
  *   Remove mode (PB0:H, PB1:L, PB2:H) [LED on PB3 is blinking]: The remote control/key code will be removed by 
- *    pressing any key. After a successful operation LED on PB3 will blink fast 10 times. The data will be sent to 
- *    the UART.
+ *    pressing any key. After a successful operation LED on PB3 will blink fast 10 times. The data will be reported 
+ *    to the UART.
  *   Delete All mode (PB0:H, PB1:H, PB2:L): All saved remote controls/key codes will be removed by making PB2 low 
  *    for a short time. After a successful operation LED on PB3 will blink fast 10 times.
+ *  The RF signal is connected to INT0 (PD2). If ASKRmt_INPUTCAPTURE is defined, it is connected to ICP1 (PB0) and the 
+ *  add mode switch is moved to PD2.
+ *  The UART (9600bps, 8N1) reports lines of text: "frame XXXXXX" for each received frame, followed by " key N" if the 
+ *  remote control/key code is saved, "saved XXXXXX", "deleted XXXXXX", "deleted all" and "dropped N" when N bytes of 
+ *  reports did not fit in the transmit buffer. The main loop only adds the reports to the buffer and the UART data 
+ *  register empty interrupt sends them.
+ *  The UART also serves the bulk export and import protocol of ASKRemoteControlTransfer.h for the ASKRmtTransfer host 
+ *  tool. The received frames are not reported for 2 seconds after a byte is received from the UART.
+ *  The received frames and the presses and releases of the keys are delivered to the OnFrame and OnPress handlers 
+ *  by ASKRmt_Dispatch. The repeats of a held key are collapsed, so each press is reported once. Timer0 wakes the 
+ *  main loop every 16.4ms to handle the switches and the LED, and the main loop sleeps in idle mode until the next 
+ *  interrupt.
  *
  * This program is published under the terms of the MIT License.
  * This program is free software and can be distributed by everyone.
@@ -23,16 +35,23 @@
  *
  *   Created: 05 May 2019 1:02 AM
  *    Author: Mohammad Yousefi (www.dihav.com - mohammad-yousefi.id.ir - vahidyou@gmail.com)
- * Last Edit: 08 Jun 2021
+ * Last Edit: 16 Oct 2026
  */
 
 #define F_CPU 1000000UL
 
 #include <avr/io.h>
-#include <util/delay.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 #include "../ASK Remote Control Decoder/ASKRemoteControlDecoder.h"
 
+#ifdef ASKRmt_DISPATCHINISR
+#error "The press handler of the test project saves and deletes codes, so ASKRmt_DISPATCHINISR must be commented."
+#endif
+
+#ifndef ASKRmt_INPUTCAPTURE
+#define ADD_SWITCH_PRESSED (!(PINB & (1 << PINB0)))
+
 ISR(INT0_vect)
 {
 	ASKRmt_RFSignalPinChanged(PIND & (1 << PIND2));
@@ -42,20 +61,268 @@ ISR(TIMER1_OVF_vect)
 {
 	ASKRmt_TwoByte1MHzTimerOverflowInterrupt();
 }
+#else
+#define ADD_SWITCH_PRESSED (!(PIND & (1 << PIND2)))
+
+ISR(TIMER1_CAPT_vect)
+{
+	ASKRmt_InputCaptureInterrupt();
+}
+
+ISR(TIMER1_COMPA_vect)
+{
+	ASKRmt_InputCaptureTimeoutInterrupt();
+}
+#endif
+
+ISR(EE_RDY_vect)
+{
+	ASKRmt_EEPROMReadyInterrupt();
+}
+
+/* 9600bps is the fastest standard rate of the 1MHz clock with a small error 
+   (0.2% in double speed mode).                                                */
+#define UART_BAUD 9600
+#define UART_UBRR ((F_CPU + 4 * UART_BAUD) / (8 * UART_BAUD) - 1)
+
+/* Ring of the bytes to send. The main loop only adds bytes and the data 
+   register empty interrupt sends them, so the reports do not stall the main 
+   loop. A report that does not fit is dropped and its bytes are counted.      */
+#define UART_TXBUFFER_SIZE 128
+volatile uint8_t UARTTxBuffer[UART_TXBUFFER_SIZE];
+volatile uint8_t UARTTxHead = 0, UARTTxTail = 0;
+uint16_t UARTTxDropped = 0; // bytes of the dropped reports, stops counting at 65535
 
+ISR(USART_UDRE_vect)
+{
+	uint8_t head = UARTTxHead;
+	UDR = UARTTxBuffer[head];
+	head = (head + 1) & (UART_TXBUFFER_SIZE - 1);
+	UARTTxHead = head;
+	if (head == UARTTxTail) UCSRB &= ~(1 << UDRIE); // the ring is empty
+}
+
+uint8_t UART_TXFree(void)
+{
+	return (UARTTxHead - UARTTxTail - 1) & (UART_TXBUFFER_SIZE - 1);
+}
+
+/* Adds "n" bytes to the ring or drops all of them if they do not fit. Returns 
+   false if they are dropped.                                                  */
+bool UART_Write(const uint8_t *d, uint8_t n)
+{
+	if (UART_TXFree() < n)
+	{
+		UARTTxDropped = (UARTTxDropped > 0xFFFF - n) ? 0xFFFF : (UARTTxDropped + n);
+		return false;
+	}
+	uint8_t tail = UARTTxTail;
+	for (uint8_t i = 0; i < n; i++)
+	{
+		UARTTxBuffer[tail] = d[i];
+		tail = (tail + 1) & (UART_TXBUFFER_SIZE - 1);
+	}
+	UARTTxTail = tail;
+	UCSRB |= (1 << UDRIE); // after the bytes are added
+	return true;
+}
+
+/* Adds a byte to the ring and waits while it is full, so the responses of the 
+   bulk transfer are not dropped.                                              */
 void UART_TX(uint8_t d)
 {
-	while (!(UCSRA & (1 << UDRE))) ;
-	UDR = d;
+	while (!UART_TXFree()) ;
+	UART_Write(&d, 1);
+}
+
+uint8_t AppendHex(uint8_t *line, uint8_t n, uint8_t d)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	line[n++] = hex[d >> 4];
+	line[n++] = hex[d & 0xF];
+	return n;
+}
+
+uint8_t AppendDecimal(uint8_t *line, uint8_t n, uint16_t d)
+{
+	uint8_t digits[5], count = 0;
+	do
+	{
+		digits[count++] = '0' + d % 10;
+		d /= 10;
+	} while (d);
+	while (count) line[n++] = digits[--count];
+	return n;
+}
+
+/* Reports a line "event XXXXXX key N" with the ASKRmt_DATA_SIZE bytes of the 
+   code. The code is left out if "code" is 0 and the key is left out if "key" 
+   is negative. The whole line is dropped if it does not fit in the ring.      */
+void Report(const char *event, const uint8_t *code, int8_t key)
+{
+	uint8_t line[24 + 2 * ASKRmt_DATA_SIZE], n = 0;
+	while (*event) line[n++] = *event++;
+	if (code)
+	{
+		line[n++] = ' ';
+		for (uint8_t i = 0; i < ASKRmt_DATA_SIZE; i++) n = AppendHex(line, n, code[i]);
+	}
+	if (key >= 0)
+	{
+		for (const char *k = " key "; *k; k++) line[n++] = *k;
+		n = AppendDecimal(line, n, key);
+	}
+	line[n++] = '\r';
+	line[n++] = '\n';
+	UART_Write(line, n);
+}
+
+/* Reports the dropped bytes once the report fits in the ring.                 */
+void ReportDropped(void)
+{
+	static uint16_t reported = 0;
+	if (reported == UARTTxDropped) return;
+	uint8_t line[16] = { 'd', 'r', 'o', 'p', 'p', 'e', 'd', ' ' }, n;
+	uint16_t dropped = UARTTxDropped;
+	n = AppendDecimal(line, 8, dropped);
+	line[n++] = '\r';
+	line[n++] = '\n';
+	if (UART_Write(line, n)) reported = dropped;
+}
+
+/* Ring of the bytes received from the UART. The RX complete interrupt adds
+   them and the main loop passes them to the bulk transfer protocol. A byte
+   that does not fit is dropped and the host sends its frame again.            */
+#define UART_RXBUFFER_SIZE 64
+volatile uint8_t UARTRxBuffer[UART_RXBUFFER_SIZE];
+volatile uint8_t UARTRxHead = 0, UARTRxTail = 0;
+uint8_t TransferIdle = 0; // ticks until the received data is sent to the UART again
+
+ISR(USART_RXC_vect)
+{
+	uint8_t d = UDR;
+	uint8_t next = (UARTRxTail + 1) & (UART_RXBUFFER_SIZE - 1);
+	if (next == UARTRxHead) return;
+	UARTRxBuffer[UARTRxTail] = d;
+	UARTRxTail = next;
+}
+
+/* Passes the received UART bytes to the bulk transfer protocol.               */
+void ServeUART(void)
+{
+	while (UARTRxHead != UARTRxTail)
+	{
+		uint8_t d = UARTRxBuffer[UARTRxHead];
+		UARTRxHead = (UARTRxHead + 1) & (UART_RXBUFFER_SIZE - 1);
+		#if defined(ASKRmt_SAVEREMOTECONTROLSTOEEPROM) || defined(ASKRmt_SAVEKEYCODESTOEEPROM)
+		ASKRmt_TransferReceivedByte(d, UART_TX);
+		#else
+		(void)d;
+		#endif
+		TransferIdle = 122; // 2 seconds
+	}
+}
+
+/* Timer0 overflows every 16.4 milliseconds (1MHz/64/256) and wakes the main
+   loop, which handles the switches and the LED on PB3 once per tick.          */
+volatile uint8_t Ticks = 0; // overflows that are not handled by the main loop yet
+uint8_t DoneBlinks = 0;     // remaining LED toggles of the work done signal
+
+ISR(TIMER0_OVF_vect)
+{
+	Ticks++;
 }
 
 void LEDWorkDoneSignal(void) {
 	// blink LED 10 times fast
-	for (uint8_t i = 0; i < 20; i++)
+	DoneBlinks = 20;
+}
+
+void Tick(void)
+{
+	static uint8_t count = 0;
+	count++;
+	if (TransferIdle) TransferIdle--;
+	if (DoneBlinks)
 	{
-		PORTB ^= (1 << PORTB3);
-		_delay_ms(50);
+		if (!(count % 3)) // 50ms
+		{
+			PORTB ^= (1 << PORTB3);
+			DoneBlinks--;
+		}
 	}
+	else if (ADD_SWITCH_PRESSED) // add mode switch
+		PORTB |= (1 << PORTB3); // turn on LED
+	else if (!(PINB & (1 << PINB1))) // remove mode switch
+	{
+		if (!(count % 12)) PORTB ^= (1 << PORTB3); // blink LED every 200ms
+	}
+	else if (!(PINB & (1 << PINB2))) // delete all button
+	{
+		#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+		ASKRmt_DeleteAllRemotes();
+		#endif
+		#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+		ASKRmt_DeleteAllKeys();
+		#endif
+		Report("deleted all", 0, -1);
+		LEDWorkDoneSignal();
+	}
+	else
+		PORTB &= ~(1 << PORTB3); // turn off LED
+}
+
+/* Reports each received frame to the serial port for saved and unsaved remote
+   controls.                                                                   */
+void OnFrame(const ASKRmt_Event *event)
+{
+	if (!TransferIdle) // do not mix it with the responses of the bulk transfer
+		Report("frame", event->Data, event->IsSaved ? event->Key : -1);
+}
+
+/* Saves or deletes the code on the first frame of a press and shows the key on
+   LEDs until the key is released.                                             */
+void OnPress(const ASKRmt_Event *event)
+{
+	if (ASKRmt_EVENT_RELEASE == event->Type)
+	{
+		PORTC = 0;
+		return;
+	}
+	if (ASKRmt_EVENT_PRESS != event->Type) return; // the key is held
+	int8_t key = event->IsSaved ? event->Key : -1;
+	if (ADD_SWITCH_PRESSED) // add mode switch
+	{
+		#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+		if (ASKRmt_SaveRemoteAutoDetectType())
+		{
+			key = ASKRmt_GetKeyIfRemoteSaved();
+		#endif
+		#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+		if (ASKRmt_SaveKey())
+		{
+			key = event->Data[ASKRmt_DATA_SIZE - 1];
+		#endif
+			Report("saved", event->Data, -1);
+			LEDWorkDoneSignal();
+		}
+	}
+	else if (!(PINB & (1 << PINB1))) // remove mode switch
+	{
+		#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
+		if (ASKRmt_DeleteRemote())
+		#endif
+		#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
+		if (ASKRmt_DeleteKey())
+		#endif
+		{
+			Report("deleted", event->Data, -1);
+			LEDWorkDoneSignal();
+		}
+		key = -1;
+	}
+	// show key on LEDs only for saved remote controls
+	if (key >= 0) PORTC = key;
 }
 
 int main(void)
@@ -63,93 +330,60 @@ int main(void)
 	// ports configurations
 	ACSR |= (1 << ACD); // turn off analog comparator
 	DDRB  = 0b11111000; // add switch, remove switch and delete all button pins input, others output
-	PORTB = 0b00000111; // enable inputs pull-ups
 	DDRC  = 0b111111;   // all output
-	DDRD  = 0b11111011; // INT0 input for ASK, others output
+	DDRD  = 0b11111011; // PD2 input (INT0 for ASK or add switch), others output
+	#ifndef ASKRmt_INPUTCAPTURE
+	PORTB = 0b00000111; // enable inputs pull-ups
 	// interrupts configurations
 	MCUCR = (1 << ISC00); // select both edges for INT0
 	GICR  = (1 << INT0);  // enable INT0 interrupt
 	TIMSK = (1 << TOIE1); // enable timer1 overflow interrupt
+	#else
+	PORTB = 0b00000110; // enable switches pull-ups, ICP1 input for ASK
+	PORTD = 0b00000100; // enable add switch pull-up
+	// ASKRmt_Init starts timer1 and its input capture interrupt
+	#endif
 	// UART	configurations
-	UBRRH = 0; UBRRL = 25;                              // 2400bps
-	UCSRB = (1 << TXEN);                                // enable TX
+	UBRRH = UART_UBRR >> 8; UBRRL = UART_UBRR & 0xFF;  // 9600bps
+	UCSRA = (1 << U2X);                                 // double speed mode
+	UCSRB = (1 << RXEN) | (1 << TXEN) | (1 << RXCIE);   // enable RX, TX and RX complete interrupt
 	UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0); // select 8-bit data
-	
-	uint8_t dataASK[3];
+
+	ASKRmt_Init();
 	#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
 	ASKRmt_AutoDiscardUnsavedRemotes = false;
 	#endif
 	#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
 	ASKRmt_AutoDiscardUnsavedKeys = false;
 	#endif
-	
+	ASKRmt_SetFrameHandler(OnFrame);
+	ASKRmt_SetPressHandler(OnPress);
+	// timer0 configurations
+	TCCR0 = (1 << CS01) | (1 << CS00); // 1MHz/64
+	TIMSK |= (1 << TOIE0);             // enable timer0 overflow interrupt
+	set_sleep_mode(SLEEP_MODE_IDLE);   // the timers, the UART and the EEPROM work while sleeping
+
 	sei();
 	while (1)
 	{
-		
-		
-		if (!(PINB & (1 << PINB0))) // add mode switch
-		{
-			PORTB |= (1 << PORTB3); // turn on LED
-			if (ASKRmt_IsDataReceived())
-				#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
-				if (ASKRmt_SaveRemoteAutoDetectType())
-				#endif
-				#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
-				if (ASKRmt_SaveKey())
-				#endif
-					LEDWorkDoneSignal();
-		}
-		else if (!(PINB & (1 << PINB1))) // remove mode switch
-		{
-			PORTB ^= (1 << PORTB3); // blink LED
-			if (ASKRmt_IsDataReceived())
-				#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
-				if (ASKRmt_PickDataAndDeleteRemote())
-				#endif
-				#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
-				if (ASKRmt_PickDataAndDeleteKey())
-				#endif
-					LEDWorkDoneSignal();
-		}
-		else if (!(PINB & (1 << PINB2))) // delete all button
-		{
-			#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
-			ASKRmt_DeleteAllRemotes();
-			#endif
-			#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
-			ASKRmt_DeleteAllKeys();
-			#endif
-			LEDWorkDoneSignal();
-		}
-		else
-			PORTB &= ~(1 << PORTB3); // turn off LED
-		
-		
-		// read received data
-		if (ASKRmt_GetData(dataASK))
+		ASKRmt_Dispatch(); // deliver the received frames and the releases to the handlers
+		ServeUART();
+		cli();
+		uint8_t ticks = Ticks;
+		Ticks = 0;
+		sei();
+		while (ticks--) Tick();
+		if (!TransferIdle) ReportDropped();
+
+		// sleep until the next interrupt if there is nothing to do
+		cli();
+		if (ASKRmt_IsReceiveQueueEmpty() && (UARTRxHead == UARTRxTail) && !Ticks)
 		{
-			// print data to the serial port for saved and unsaved remote controls
-			UART_TX(dataASK[0]);
-			UART_TX(dataASK[1]);
-			UART_TX(dataASK[2]);
-			// show key on LEDs only for saved remote controls
-			#ifdef ASKRmt_SAVEREMOTECONTROLSTOEEPROM
-			int8_t key = ASKRmt_PickKeyIfRemoteSaved();
-			if (key >= 0)
-			#endif
-			#ifdef ASKRmt_SAVEKEYCODESTOEEPROM
-			uint8_t key;
-			if (ASKRmt_PickKeyIfKeySaved(&key))
-			#endif
-			{
-				PORTC = key;
-				_delay_ms(200);
-				PORTC = 0;
-			}
+			sleep_enable();
+			sei(); // the instruction after sei is executed before any interrupt, so no wake up is missed
+			sleep_cpu();
+			sleep_disable();
 		}
-		
-		
-		_delay_ms(200);
+		sei();
 	}
-}
\ No newline at end of file
+}